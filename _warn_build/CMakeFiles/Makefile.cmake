@@ -0,0 +1,75 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/tests/CMakeLists.txt"
+  "/usr/lib/cmake/Catch2/Catch.cmake"
+  "/usr/lib/cmake/Catch2/Catch2Config.cmake"
+  "/usr/lib/cmake/Catch2/Catch2ConfigVersion.cmake"
+  "/usr/lib/cmake/Catch2/Catch2Targets-none.cmake"
+  "/usr/lib/cmake/Catch2/Catch2Targets.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFileCXX.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/vfs.dir/DependInfo.cmake"
+  "tests/CMakeFiles/testing.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-all.dir/DependInfo.cmake"
+  "tests/CMakeFiles/run-test.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-copy.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-directory_entry.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-entry.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-mem_file.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-mem_fs.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-mount.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-name.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-os_file.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-os_fs.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-read_only_fs.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-union_file.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-union_fs.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-vfile.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-vfs.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test-example.dir/DependInfo.cmake"
+  )
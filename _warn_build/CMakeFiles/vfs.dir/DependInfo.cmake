@@ -0,0 +1,35 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/copy.cpp" "CMakeFiles/vfs.dir/src/copy.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/copy.cpp.o.d"
+  "/root/repo/src/entry.cpp" "CMakeFiles/vfs.dir/src/entry.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/entry.cpp.o.d"
+  "/root/repo/src/file.cpp" "CMakeFiles/vfs.dir/src/file.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/file.cpp.o.d"
+  "/root/repo/src/fs.cpp" "CMakeFiles/vfs.dir/src/fs.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/fs.cpp.o.d"
+  "/root/repo/src/io_engine.cpp" "CMakeFiles/vfs.dir/src/io_engine.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/io_engine.cpp.o.d"
+  "/root/repo/src/lookup_cache.cpp" "CMakeFiles/vfs.dir/src/lookup_cache.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/lookup_cache.cpp.o.d"
+  "/root/repo/src/mem_file.cpp" "CMakeFiles/vfs.dir/src/mem_file.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/mem_file.cpp.o.d"
+  "/root/repo/src/mem_fs.cpp" "CMakeFiles/vfs.dir/src/mem_fs.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/mem_fs.cpp.o.d"
+  "/root/repo/src/mount.cpp" "CMakeFiles/vfs.dir/src/mount.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/mount.cpp.o.d"
+  "/root/repo/src/name.cpp" "CMakeFiles/vfs.dir/src/name.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/name.cpp.o.d"
+  "/root/repo/src/os_file.cpp" "CMakeFiles/vfs.dir/src/os_file.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/os_file.cpp.o.d"
+  "/root/repo/src/os_fs.cpp" "CMakeFiles/vfs.dir/src/os_fs.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/os_fs.cpp.o.d"
+  "/root/repo/src/union_file.cpp" "CMakeFiles/vfs.dir/src/union_file.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/union_file.cpp.o.d"
+  "/root/repo/src/union_fs.cpp" "CMakeFiles/vfs.dir/src/union_fs.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/union_fs.cpp.o.d"
+  "/root/repo/src/utils.cpp" "CMakeFiles/vfs.dir/src/utils.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/utils.cpp.o.d"
+  "/root/repo/src/vfile.cpp" "CMakeFiles/vfs.dir/src/vfile.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/vfile.cpp.o.d"
+  "/root/repo/src/vfs.cpp" "CMakeFiles/vfs.dir/src/vfs.cpp.o" "gcc" "CMakeFiles/vfs.dir/src/vfs.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
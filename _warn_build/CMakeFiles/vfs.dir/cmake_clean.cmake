@@ -0,0 +1,43 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/vfs.dir/src/copy.cpp.o"
+  "CMakeFiles/vfs.dir/src/copy.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/entry.cpp.o"
+  "CMakeFiles/vfs.dir/src/entry.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/file.cpp.o"
+  "CMakeFiles/vfs.dir/src/file.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/fs.cpp.o"
+  "CMakeFiles/vfs.dir/src/fs.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/io_engine.cpp.o"
+  "CMakeFiles/vfs.dir/src/io_engine.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/lookup_cache.cpp.o"
+  "CMakeFiles/vfs.dir/src/lookup_cache.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/mem_file.cpp.o"
+  "CMakeFiles/vfs.dir/src/mem_file.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/mem_fs.cpp.o"
+  "CMakeFiles/vfs.dir/src/mem_fs.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/mount.cpp.o"
+  "CMakeFiles/vfs.dir/src/mount.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/name.cpp.o"
+  "CMakeFiles/vfs.dir/src/name.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/os_file.cpp.o"
+  "CMakeFiles/vfs.dir/src/os_file.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/os_fs.cpp.o"
+  "CMakeFiles/vfs.dir/src/os_fs.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/union_file.cpp.o"
+  "CMakeFiles/vfs.dir/src/union_file.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/union_fs.cpp.o"
+  "CMakeFiles/vfs.dir/src/union_fs.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/utils.cpp.o"
+  "CMakeFiles/vfs.dir/src/utils.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/vfile.cpp.o"
+  "CMakeFiles/vfs.dir/src/vfile.cpp.o.d"
+  "CMakeFiles/vfs.dir/src/vfs.cpp.o"
+  "CMakeFiles/vfs.dir/src/vfs.cpp.o.d"
+  "libvfs.pdb"
+  "libvfs.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/vfs.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-copy.dir/src/copy.cpp.o"
+  "CMakeFiles/test-copy.dir/src/copy.cpp.o.d"
+  "copy"
+  "copy.pdb"
+  "test-copy_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-copy.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-directory_entry.dir/src/directory_entry.cpp.o"
+  "CMakeFiles/test-directory_entry.dir/src/directory_entry.cpp.o.d"
+  "directory_entry"
+  "directory_entry.pdb"
+  "test-directory_entry_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-directory_entry.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-entry.dir/src/entry.cpp.o"
+  "CMakeFiles/test-entry.dir/src/entry.cpp.o.d"
+  "entry"
+  "entry.pdb"
+  "test-entry_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-entry.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
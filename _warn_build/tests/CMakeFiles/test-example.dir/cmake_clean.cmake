@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-example.dir/src/example.cpp.o"
+  "CMakeFiles/test-example.dir/src/example.cpp.o.d"
+  "example"
+  "example.pdb"
+  "test-example_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-example.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-mem_file.dir/src/mem_file.cpp.o"
+  "CMakeFiles/test-mem_file.dir/src/mem_file.cpp.o.d"
+  "mem_file"
+  "mem_file.pdb"
+  "test-mem_file_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-mem_file.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
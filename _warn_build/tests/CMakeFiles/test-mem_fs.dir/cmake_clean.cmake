@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-mem_fs.dir/src/mem_fs.cpp.o"
+  "CMakeFiles/test-mem_fs.dir/src/mem_fs.cpp.o.d"
+  "mem_fs"
+  "mem_fs.pdb"
+  "test-mem_fs_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-mem_fs.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-mount.dir/src/mount.cpp.o"
+  "CMakeFiles/test-mount.dir/src/mount.cpp.o.d"
+  "mount"
+  "mount.pdb"
+  "test-mount_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-mount.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
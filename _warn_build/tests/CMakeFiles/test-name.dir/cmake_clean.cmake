@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-name.dir/src/name.cpp.o"
+  "CMakeFiles/test-name.dir/src/name.cpp.o.d"
+  "name"
+  "name.pdb"
+  "test-name_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-name.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
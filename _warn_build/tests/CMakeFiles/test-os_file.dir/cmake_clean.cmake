@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-os_file.dir/src/os_file.cpp.o"
+  "CMakeFiles/test-os_file.dir/src/os_file.cpp.o.d"
+  "os_file"
+  "os_file.pdb"
+  "test-os_file_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-os_file.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
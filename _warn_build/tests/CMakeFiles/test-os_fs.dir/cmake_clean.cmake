@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-os_fs.dir/src/os_fs.cpp.o"
+  "CMakeFiles/test-os_fs.dir/src/os_fs.cpp.o.d"
+  "os_fs"
+  "os_fs.pdb"
+  "test-os_fs_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-os_fs.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-read_only_fs.dir/src/read_only_fs.cpp.o"
+  "CMakeFiles/test-read_only_fs.dir/src/read_only_fs.cpp.o.d"
+  "read_only_fs"
+  "read_only_fs.pdb"
+  "test-read_only_fs_tests-b12d07c.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-read_only_fs.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
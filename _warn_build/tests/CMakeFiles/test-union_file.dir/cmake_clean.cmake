@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-union_file.dir/src/union_file.cpp.o"
+  "CMakeFiles/test-union_file.dir/src/union_file.cpp.o.d"
+  "test-union_file_tests-b12d07c.cmake"
+  "union_file"
+  "union_file.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-union_file.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-union_fs.dir/src/union_fs.cpp.o"
+  "CMakeFiles/test-union_fs.dir/src/union_fs.cpp.o.d"
+  "test-union_fs_tests-b12d07c.cmake"
+  "union_fs"
+  "union_fs.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-union_fs.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-vfile.dir/src/vfile.cpp.o"
+  "CMakeFiles/test-vfile.dir/src/vfile.cpp.o.d"
+  "test-vfile_tests-b12d07c.cmake"
+  "vfile"
+  "vfile.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-vfile.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-vfs.dir/src/vfs.cpp.o"
+  "CMakeFiles/test-vfs.dir/src/vfs.cpp.o.d"
+  "test-vfs_tests-b12d07c.cmake"
+  "vfs"
+  "vfs.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-vfs.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testing.dir/src/testing.cpp.o"
+  "CMakeFiles/testing.dir/src/testing.cpp.o.d"
+  "libtesting.a"
+  "libtesting.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testing.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
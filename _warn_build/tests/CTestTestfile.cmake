@@ -0,0 +1,21 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests
+# Build directory: /root/repo/_warn_build/tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+include("/root/repo/_warn_build/tests/test-copy_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-directory_entry_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-entry_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-mem_file_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-mem_fs_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-mount_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-name_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-os_file_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-os_fs_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-read_only_fs_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-union_file_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-union_fs_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-vfile_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-vfs_include-b12d07c.cmake")
+include("/root/repo/_warn_build/tests/test-example_include-b12d07c.cmake")
@@ -0,0 +1,17 @@
+add_test( [==[Copy from OsFs to OsFs]==] /root/repo/_warn_build/tests/copy [==[Copy from OsFs to OsFs]==]  )
+set_tests_properties( [==[Copy from OsFs to OsFs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Copy from OsFs to Vfs]==] /root/repo/_warn_build/tests/copy [==[Copy from OsFs to Vfs]==]  )
+set_tests_properties( [==[Copy from OsFs to Vfs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Copy from Vfs to OsFs]==] /root/repo/_warn_build/tests/copy [==[Copy from Vfs to OsFs]==]  )
+set_tests_properties( [==[Copy from Vfs to OsFs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Copy from Vfs to Vfs]==] /root/repo/_warn_build/tests/copy [==[Copy from Vfs to Vfs]==]  )
+set_tests_properties( [==[Copy from Vfs to Vfs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Copy from Vfs to Vfs in parallel]==] /root/repo/_warn_build/tests/copy [==[Copy from Vfs to Vfs in parallel]==]  )
+set_tests_properties( [==[Copy from Vfs to Vfs in parallel]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Copy from Vfs to OsFs in parallel]==] /root/repo/_warn_build/tests/copy [==[Copy from Vfs to OsFs in parallel]==]  )
+set_tests_properties( [==[Copy from Vfs to OsFs in parallel]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Copy within an OsFs mounted on Vfs]==] /root/repo/_warn_build/tests/copy [==[Copy within an OsFs mounted on Vfs]==]  )
+set_tests_properties( [==[Copy within an OsFs mounted on Vfs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Copy in parallel]==] /root/repo/_warn_build/tests/copy [==[Copy in parallel]==]  )
+set_tests_properties( [==[Copy in parallel]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-copy_TESTS [==[Copy from OsFs to OsFs]==] [==[Copy from OsFs to Vfs]==] [==[Copy from Vfs to OsFs]==] [==[Copy from Vfs to Vfs]==] [==[Copy from Vfs to Vfs in parallel]==] [==[Copy from Vfs to OsFs in parallel]==] [==[Copy within an OsFs mounted on Vfs]==] [==[Copy in parallel]==])
@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_warn_build/tests/test-directory_entry_tests-b12d07c.cmake")
+  include("/root/repo/_warn_build/tests/test-directory_entry_tests-b12d07c.cmake")
+else()
+  add_test(test-directory_entry_NOT_BUILT-b12d07c test-directory_entry_NOT_BUILT-b12d07c)
+endif()
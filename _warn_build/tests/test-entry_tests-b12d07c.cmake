@@ -0,0 +1,9 @@
+add_test( Entry /root/repo/_warn_build/tests/entry Entry  )
+set_tests_properties( Entry PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( DirectoryEntry /root/repo/_warn_build/tests/entry DirectoryEntry  )
+set_tests_properties( DirectoryEntry PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( SymlinkEntry /root/repo/_warn_build/tests/entry SymlinkEntry  )
+set_tests_properties( SymlinkEntry PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( Trail /root/repo/_warn_build/tests/entry Trail  )
+set_tests_properties( Trail PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-entry_TESTS Entry DirectoryEntry SymlinkEntry Trail)
@@ -0,0 +1,5 @@
+add_test( example /root/repo/_warn_build/tests/example example  )
+set_tests_properties( example PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( mount /root/repo/_warn_build/tests/example mount  )
+set_tests_properties( mount PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-example_TESTS example mount)
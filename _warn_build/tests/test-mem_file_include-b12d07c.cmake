@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_warn_build/tests/test-mem_file_tests-b12d07c.cmake")
+  include("/root/repo/_warn_build/tests/test-mem_file_tests-b12d07c.cmake")
+else()
+  add_test(test-mem_file_NOT_BUILT-b12d07c test-mem_file_NOT_BUILT-b12d07c)
+endif()
@@ -0,0 +1,11 @@
+add_test( MemFile /root/repo/_warn_build/tests/mem_file MemFile  )
+set_tests_properties( MemFile PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( MemRegularFile /root/repo/_warn_build/tests/mem_file MemRegularFile  )
+set_tests_properties( MemRegularFile PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( PagedBuffer /root/repo/_warn_build/tests/mem_file PagedBuffer  )
+set_tests_properties( PagedBuffer PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[MemRegularFile with pages]==] /root/repo/_warn_build/tests/mem_file [==[MemRegularFile with pages]==]  )
+set_tests_properties( [==[MemRegularFile with pages]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[MemRegularFile read while written]==] /root/repo/_warn_build/tests/mem_file [==[MemRegularFile read while written]==]  )
+set_tests_properties( [==[MemRegularFile read while written]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-mem_file_TESTS MemFile MemRegularFile PagedBuffer [==[MemRegularFile with pages]==] [==[MemRegularFile read while written]==])
@@ -0,0 +1,13 @@
+add_test( MemFs /root/repo/_warn_build/tests/mem_fs MemFs  )
+set_tests_properties( MemFs PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[MemFs with chroot]==] /root/repo/_warn_build/tests/mem_fs [==[MemFs with chroot]==]  )
+set_tests_properties( [==[MemFs with chroot]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[MemFs with lookup cache]==] /root/repo/_warn_build/tests/mem_fs [==[MemFs with lookup cache]==]  )
+set_tests_properties( [==[MemFs with lookup cache]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[MemFs with sorted directories]==] /root/repo/_warn_build/tests/mem_fs [==[MemFs with sorted directories]==]  )
+set_tests_properties( [==[MemFs with sorted directories]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[MemFs with concurrent]==] /root/repo/_warn_build/tests/mem_fs [==[MemFs with concurrent]==]  )
+set_tests_properties( [==[MemFs with concurrent]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[MemFs used by multiple threads]==] /root/repo/_warn_build/tests/mem_fs [==[MemFs used by multiple threads]==]  )
+set_tests_properties( [==[MemFs used by multiple threads]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-mem_fs_TESTS MemFs [==[MemFs with chroot]==] [==[MemFs with lookup cache]==] [==[MemFs with sorted directories]==] [==[MemFs with concurrent]==] [==[MemFs used by multiple threads]==])
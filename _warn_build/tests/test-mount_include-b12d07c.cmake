@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_warn_build/tests/test-mount_tests-b12d07c.cmake")
+  include("/root/repo/_warn_build/tests/test-mount_tests-b12d07c.cmake")
+else()
+  add_test(test-mount_NOT_BUILT-b12d07c test-mount_NOT_BUILT-b12d07c)
+endif()
@@ -0,0 +1,9 @@
+add_test( [==[Mount OsFs on OsFs]==] /root/repo/_warn_build/tests/mount [==[Mount OsFs on OsFs]==]  )
+set_tests_properties( [==[Mount OsFs on OsFs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Mount Vfs on OsFs]==] /root/repo/_warn_build/tests/mount [==[Mount Vfs on OsFs]==]  )
+set_tests_properties( [==[Mount Vfs on OsFs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Mount OsFs on Vfs]==] /root/repo/_warn_build/tests/mount [==[Mount OsFs on Vfs]==]  )
+set_tests_properties( [==[Mount OsFs on Vfs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Mount Vfs on Vfs]==] /root/repo/_warn_build/tests/mount [==[Mount Vfs on Vfs]==]  )
+set_tests_properties( [==[Mount Vfs on Vfs]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-mount_TESTS [==[Mount OsFs on OsFs]==] [==[Mount Vfs on OsFs]==] [==[Mount OsFs on Vfs]==] [==[Mount Vfs on Vfs]==])
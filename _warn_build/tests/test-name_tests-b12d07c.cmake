@@ -0,0 +1,3 @@
+add_test( Name /root/repo/_warn_build/tests/name Name  )
+set_tests_properties( Name PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-name_TESTS Name)
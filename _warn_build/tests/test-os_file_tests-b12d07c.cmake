@@ -0,0 +1,17 @@
+add_test( OsFile /root/repo/_warn_build/tests/os_file OsFile  )
+set_tests_properties( OsFile PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( OsRegularFile::copy_from /root/repo/_warn_build/tests/os_file OsRegularFile::copy_from  )
+set_tests_properties( OsRegularFile::copy_from PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( OsRegularFile::map_read /root/repo/_warn_build/tests/os_file OsRegularFile::map_read  )
+set_tests_properties( OsRegularFile::map_read PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( TempRegularFile /root/repo/_warn_build/tests/os_file TempRegularFile  )
+set_tests_properties( TempRegularFile PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( TempDirectory /root/repo/_warn_build/tests/os_file TempDirectory  )
+set_tests_properties( TempDirectory PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( OsDirectory::cursor /root/repo/_warn_build/tests/os_file OsDirectory::cursor  )
+set_tests_properties( OsDirectory::cursor PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[OsDirectory replaced at its path]==] /root/repo/_warn_build/tests/os_file [==[OsDirectory replaced at its path]==]  )
+set_tests_properties( [==[OsDirectory replaced at its path]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( OsFile::stat /root/repo/_warn_build/tests/os_file OsFile::stat  )
+set_tests_properties( OsFile::stat PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-os_file_TESTS OsFile OsRegularFile::copy_from OsRegularFile::map_read TempRegularFile TempDirectory OsDirectory::cursor [==[OsDirectory replaced at its path]==] OsFile::stat)
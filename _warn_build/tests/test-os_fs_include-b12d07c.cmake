@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_warn_build/tests/test-os_fs_tests-b12d07c.cmake")
+  include("/root/repo/_warn_build/tests/test-os_fs_tests-b12d07c.cmake")
+else()
+  add_test(test-os_fs_NOT_BUILT-b12d07c test-os_fs_NOT_BUILT-b12d07c)
+endif()
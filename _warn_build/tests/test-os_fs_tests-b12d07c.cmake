@@ -0,0 +1,11 @@
+add_test( OsFs /root/repo/_warn_build/tests/os_fs OsFs  )
+set_tests_properties( OsFs PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[OsFs with chroot]==] /root/repo/_warn_build/tests/os_fs [==[OsFs with chroot]==]  )
+set_tests_properties( [==[OsFs with chroot]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( ChRootedStdFs::os_path_of /root/repo/_warn_build/tests/os_fs ChRootedStdFs::os_path_of  )
+set_tests_properties( ChRootedStdFs::os_path_of PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[StdFs::status_many on many paths]==] /root/repo/_warn_build/tests/os_fs [==[StdFs::status_many on many paths]==]  )
+set_tests_properties( [==[StdFs::status_many on many paths]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[StdFs::async_* on many files at once]==] /root/repo/_warn_build/tests/os_fs [==[StdFs::async_* on many files at once]==]  )
+set_tests_properties( [==[StdFs::async_* on many files at once]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-os_fs_TESTS OsFs [==[OsFs with chroot]==] ChRootedStdFs::os_path_of [==[StdFs::status_many on many paths]==] [==[StdFs::async_* on many files at once]==])
@@ -0,0 +1,3 @@
+add_test( ReadOnlyFsProxy /root/repo/_warn_build/tests/read_only_fs ReadOnlyFsProxy  )
+set_tests_properties( ReadOnlyFsProxy PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-read_only_fs_TESTS ReadOnlyFsProxy)
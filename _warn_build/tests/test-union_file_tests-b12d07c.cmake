@@ -0,0 +1,5 @@
+add_test( UnionFile /root/repo/_warn_build/tests/union_file UnionFile  )
+set_tests_properties( UnionFile PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( UnionDirectory /root/repo/_warn_build/tests/union_file UnionDirectory  )
+set_tests_properties( UnionDirectory PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-union_file_TESTS UnionFile UnionDirectory)
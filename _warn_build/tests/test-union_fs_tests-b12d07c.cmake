@@ -0,0 +1 @@
+set( test-union_fs_TESTS)
@@ -0,0 +1,11 @@
+add_test( VFile /root/repo/_warn_build/tests/vfile VFile  )
+set_tests_properties( VFile PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[VFile with sorted directories]==] /root/repo/_warn_build/tests/vfile [==[VFile with sorted directories]==]  )
+set_tests_properties( [==[VFile with sorted directories]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( SortedVDirectory /root/repo/_warn_build/tests/vfile SortedVDirectory  )
+set_tests_properties( SortedVDirectory PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( VRegularFile /root/repo/_warn_build/tests/vfile VRegularFile  )
+set_tests_properties( VRegularFile PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( LookupCache /root/repo/_warn_build/tests/vfile LookupCache  )
+set_tests_properties( LookupCache PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-vfile_TESTS VFile [==[VFile with sorted directories]==] SortedVDirectory VRegularFile LookupCache)
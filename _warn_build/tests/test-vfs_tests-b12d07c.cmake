@@ -0,0 +1,17 @@
+add_test( Vfs /root/repo/_warn_build/tests/vfs Vfs  )
+set_tests_properties( Vfs PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Vfs with chroot]==] /root/repo/_warn_build/tests/vfs [==[Vfs with chroot]==]  )
+set_tests_properties( [==[Vfs with chroot]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Vfs with lookup cache]==] /root/repo/_warn_build/tests/vfs [==[Vfs with lookup cache]==]  )
+set_tests_properties( [==[Vfs with lookup cache]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Vfs with sorted directories]==] /root/repo/_warn_build/tests/vfs [==[Vfs with sorted directories]==]  )
+set_tests_properties( [==[Vfs with sorted directories]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Vfs with concurrent]==] /root/repo/_warn_build/tests/vfs [==[Vfs with concurrent]==]  )
+set_tests_properties( [==[Vfs with concurrent]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Vfs with OsFs mounted]==] /root/repo/_warn_build/tests/vfs [==[Vfs with OsFs mounted]==]  )
+set_tests_properties( [==[Vfs with OsFs mounted]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Vfs lookup cache]==] /root/repo/_warn_build/tests/vfs [==[Vfs lookup cache]==]  )
+set_tests_properties( [==[Vfs lookup cache]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+add_test( [==[Vfs::async_* on an OsFs mounted]==] /root/repo/_warn_build/tests/vfs [==[Vfs::async_* on an OsFs mounted]==]  )
+set_tests_properties( [==[Vfs::async_* on an OsFs mounted]==] PROPERTIES WORKING_DIRECTORY /root/repo/_warn_build/tests)
+set( test-vfs_TESTS Vfs [==[Vfs with chroot]==] [==[Vfs with lookup cache]==] [==[Vfs with sorted directories]==] [==[Vfs with concurrent]==] [==[Vfs with OsFs mounted]==] [==[Vfs lookup cache]==] [==[Vfs::async_* on an OsFs mounted]==])
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <compare>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <system_error>
 #include <utility>
 
@@ -55,12 +57,44 @@ class directory_entry {
 		this->refresh(ec);
 	}
 
+	/**
+	 * @brief Assigns a new path with the file attributes given by the caller, so the file system is not queried.
+	 *   `Fs` implementations use it to fill the entries from the directory they are iterating.
+	 * 
+	 * @param[in] p     New path to assign.
+	 * @param[in] s     Status of the file, not following a symbolic link.
+	 * @param[in] size  Size of the file, or `static_cast<std::uintmax_t>(-1)` if it is not a regular file.
+	 * @param[in] mtime Last write time of the file.
+	 */
+	void assign(std::filesystem::path p, std::filesystem::file_status s, std::uintmax_t size, std::filesystem::file_time_type mtime) {
+		this->path_  = std::move(p);
+		this->type_  = s.type();
+		this->perms_ = s.permissions();
+		this->size_  = size;
+		this->mtime_ = mtime;
+	}
+
+	/**
+	 * @brief Assigns a new path with only the type of the file given by the caller.
+	 *   Other attributes are queried from the file system when they are first asked,
+	 *   so `Fs` implementations use it for the entries whose attributes cost a query.
+	 * 
+	 * @param[in] p    New path to assign.
+	 * @param[in] type Type of the file, not following a symbolic link, or `std::filesystem::file_type::none` if it is not known.
+	 */
+	void assign(std::filesystem::path p, std::filesystem::file_type type) noexcept {
+		this->path_ = std::move(p);
+		this->clear_();
+		this->type_ = type;
+	}
+
 	/**
 	 * @brief Updates the cached file attributes.
 	 * 
 	 */
 	void refresh() {
-		this->type_ = this->symlink_status().type();
+		this->clear_();
+		this->set_status_(this->symlink_status());
 	}
 
 	/**
@@ -69,7 +103,8 @@ class directory_entry {
 	 * @param[out] ec Error code to store error status to.
 	 */
 	void refresh(std::error_code& ec) noexcept {
-		this->type_ = this->symlink_status(ec).type();
+		this->clear_();
+		this->set_status_(this->symlink_status(ec));
 	}
 
 	/**
@@ -117,6 +152,9 @@ class directory_entry {
 	 * @return `true` if file or directory exists, `false` otherwise.
 	 */
 	[[nodiscard]] bool exists() const {
+		if(this->has_type_() && this->type_ != std::filesystem::file_type::symlink) {
+			return this->type_ != std::filesystem::file_type::not_found;
+		}
 		return this->fs_->exists(this->path_);
 	}
 
@@ -127,6 +165,10 @@ class directory_entry {
 	 * @return `true` if file or directory exists, `false` otherwise.
 	 */
 	bool exists(std::error_code& ec) const noexcept {
+		if(this->has_type_() && this->type_ != std::filesystem::file_type::symlink) {
+			ec.clear();
+			return this->type_ != std::filesystem::file_type::not_found;
+		}
 		return this->fs_->exists(this->path_, ec);
 	}
 
@@ -288,6 +330,9 @@ class directory_entry {
 	 * @return Size of the file in bytes.
 	 */
 	[[nodiscard]] std::uintmax_t file_size() const {
+		if(this->has_size_()) {
+			return this->size_;
+		}
 		return this->fs_->file_size(this->path_);
 	}
 
@@ -298,6 +343,10 @@ class directory_entry {
 	 * @return Size of the file in bytes.
 	 */
 	std::uintmax_t file_size(std::error_code& ec) const noexcept {
+		if(this->has_size_()) {
+			ec.clear();
+			return this->size_;
+		}
 		return this->fs_->file_size(this->path_, ec);
 	}
 
@@ -326,6 +375,9 @@ class directory_entry {
 	 * @return Last write time of the file.
 	 */
 	[[nodiscard]] std::filesystem::file_time_type last_write_time() const {
+		if(this->has_mtime_()) {
+			return *this->mtime_;
+		}
 		return this->fs_->last_write_time(this->path_);
 	}
 
@@ -336,6 +388,10 @@ class directory_entry {
 	 * @return Last write time of the file.
 	 */
 	std::filesystem::file_time_type last_write_time(std::error_code& ec) const noexcept {
+		if(this->has_mtime_()) {
+			ec.clear();
+			return *this->mtime_;
+		}
 		return this->fs_->last_write_time(this->path_, ec);
 	}
 
@@ -345,6 +401,9 @@ class directory_entry {
 	 * @return Status of the file.
 	 */
 	[[nodiscard]] std::filesystem::file_status status() const {
+		if(this->has_status_()) {
+			return std::filesystem::file_status(this->type_, this->perms_);
+		}
 		return this->fs_->status(this->path_);
 	}
 
@@ -355,7 +414,11 @@ class directory_entry {
 	 * @return Status of the file.
 	 */
 	std::filesystem::file_status status(std::error_code& ec) const noexcept {
-		return this->fs_->status(this->path_);
+		if(this->has_status_()) {
+			ec.clear();
+			return std::filesystem::file_status(this->type_, this->perms_);
+		}
+		return this->fs_->status(this->path_, ec);
 	}
 
 	/**
@@ -365,6 +428,9 @@ class directory_entry {
 	 * @return Status of the file or directory.
 	 */
 	[[nodiscard]] std::filesystem::file_status symlink_status() const {
+		if(this->has_type_() && this->perms_ != std::filesystem::perms::unknown) {
+			return std::filesystem::file_status(this->type_, this->perms_);
+		}
 		return this->fs_->symlink_status(this->path_);
 	}
 
@@ -376,6 +442,10 @@ class directory_entry {
 	 * @return Status of the file or directory.
 	 */
 	std::filesystem::file_status symlink_status(std::error_code& ec) const noexcept {
+		if(this->has_type_() && this->perms_ != std::filesystem::perms::unknown) {
+			ec.clear();
+			return std::filesystem::file_status(this->type_, this->perms_);
+		}
 		return this->fs_->symlink_status(this->path_, ec);
 	}
 
@@ -400,6 +470,39 @@ class directory_entry {
 	}
 
    private:
+	void clear_() noexcept {
+		this->type_  = std::filesystem::file_type::none;
+		this->perms_ = std::filesystem::perms::unknown;
+		this->size_  = static_cast<std::uintmax_t>(-1);
+		this->mtime_.reset();
+	}
+
+	void set_status_(std::filesystem::file_status s) noexcept {
+		this->type_  = s.type();
+		this->perms_ = s.permissions();
+	}
+
+	[[nodiscard]] bool has_type_() const noexcept {
+		return this->type_ != std::filesystem::file_type::none;
+	}
+
+	// Cached attributes of a symbolic link are of the link itself, so they cannot answer queries that follow it.
+
+	[[nodiscard]] bool has_status_() const noexcept {
+		return this->has_type_()
+		    && this->type_ != std::filesystem::file_type::not_found
+		    && this->type_ != std::filesystem::file_type::symlink
+		    && this->perms_ != std::filesystem::perms::unknown;
+	}
+
+	[[nodiscard]] bool has_size_() const noexcept {
+		return this->type_ == std::filesystem::file_type::regular && this->size_ != static_cast<std::uintmax_t>(-1);
+	}
+
+	[[nodiscard]] bool has_mtime_() const noexcept {
+		return this->mtime_.has_value() && this->type_ != std::filesystem::file_type::symlink;
+	}
+
 	[[nodiscard]] std::filesystem::file_type get_type_() const {
 		if(this->type_ != std::filesystem::file_type::none && this->type_ != std::filesystem::file_type::symlink) {
 			return this->type_;
@@ -412,12 +515,16 @@ class directory_entry {
 			ec.clear();
 			return this->type_;
 		}
-		return this->status().type();
+		return this->status(ec).type();
 	}
 
-	std::shared_ptr<Fs const>  fs_;
-	std::filesystem::path      path_;
-	std::filesystem::file_type type_ = std::filesystem::file_type::none;
+	std::shared_ptr<Fs const> fs_;
+	std::filesystem::path     path_;
+
+	std::filesystem::file_type                     type_  = std::filesystem::file_type::none;
+	std::filesystem::perms                         perms_ = std::filesystem::perms::unknown;
+	std::uintmax_t                                 size_  = static_cast<std::uintmax_t>(-1);
+	std::optional<std::filesystem::file_time_type> mtime_;
 };
 
 }  // namespace vfs
@@ -3,10 +3,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <system_error>
+#include <vector>
 
 namespace vfs {
 
@@ -14,6 +18,94 @@ class directory_entry;
 class directory_iterator;
 class recursive_directory_iterator;
 
+/**
+ * @brief Open regular file that is read and written at given offsets, without a stream and its position.
+ *   Functions throw \ref std::filesystem::filesystem_error on failure.
+ */
+class FileHandle {
+   public:
+	virtual ~FileHandle() = default;
+
+	/**
+	 * @brief Reads a part of the file.
+	 * 
+	 * @param[out] buf    Buffer to read into.
+	 * @param[in]  offset Position in the file to read from.
+	 * @return Number of bytes read, which is less than the size of \p buf only if the end of the file is reached.
+	 */
+	virtual std::size_t pread(std::span<char> buf, std::uintmax_t offset) = 0;
+
+	/**
+	 * @brief Overwrites a part of the file. The file is extended if \p data goes beyond the end, and the gap is filled with zeros.
+	 * 
+	 * @param[in] data   Data to be written.
+	 * @param[in] offset Position in the file to write at.
+	 * 
+	 * @exception \ref std::filesystem::filesystem_error if the handle is not opened for writing.
+	 */
+	virtual void pwrite(std::string_view data, std::uintmax_t offset) = 0;
+
+	/**
+	 * @brief Retrieves the size of the file.
+	 * 
+	 * @return Size of the file in bytes.
+	 */
+	[[nodiscard]] virtual std::uintmax_t size() const = 0;
+
+	/**
+	 * @brief Changes the size of the file. The file is extended with zeros if \p n is larger than its size.
+	 * 
+	 * @param[in] n New size of the file.
+	 * 
+	 * @exception \ref std::filesystem::filesystem_error if the handle is not opened for writing.
+	 */
+	virtual void truncate(std::uintmax_t n) = 0;
+
+	/**
+	 * @brief Flushes written data to the underlying storage, if any.
+	 */
+	virtual void sync() = 0;
+};
+
+/**
+ * @brief Attributes of files retrieved by \ref Fs::status_many.
+ *   Each attribute is stored in its own array, indexed in order of the queried paths.
+ *
+ *   - `types` is `std::filesystem::file_type::not_found` if the file does not exist,
+ *     or `std::filesystem::file_type::none` if the attributes could not be retrieved.
+ *   - `sizes` is `static_cast<std::uintmax_t>(-1)` if the file is not a regular file.
+ *   - `errors` holds why the attributes could not be retrieved, and is cleared if they were.
+ */
+struct FileStatuses {
+	std::vector<std::filesystem::file_type>      types;
+	std::vector<std::filesystem::perms>          perms;
+	std::vector<std::uintmax_t>                  sizes;
+	std::vector<std::filesystem::file_time_type> last_write_times;
+	std::vector<std::error_code>                 errors;
+
+	/**
+	 * @brief Resizes every array to hold attributes of \p n files, which are filled as not retrieved.
+	 * 
+	 * @param[in] n Number of files.
+	 */
+	void resize(std::size_t n) {
+		this->types.resize(n, std::filesystem::file_type::none);
+		this->perms.resize(n, std::filesystem::perms::unknown);
+		this->sizes.resize(n, static_cast<std::uintmax_t>(-1));
+		this->last_write_times.resize(n, std::filesystem::file_time_type::min());
+		this->errors.resize(n);
+	}
+
+	/**
+	 * @brief Returns the number of files.
+	 * 
+	 * @return Number of files.
+	 */
+	[[nodiscard]] std::size_t size() const noexcept {
+		return this->types.size();
+	}
+};
+
 class Fs: public std::enable_shared_from_this<Fs> {
    public:
 	virtual ~Fs() = default;
@@ -56,6 +148,113 @@ class Fs: public std::enable_shared_from_this<Fs> {
 		return this->open_write(filename, std::ios_base::out);
 	}
 
+	/**
+	 * @brief Opens a file for reading through a memory mapping, so the contents are read in place without copying.
+	 *   Only large regular files of the OS are mapped; others are opened as \ref open_read does.
+	 *   If another process truncates a mapped file while it is read, the reading process receives `SIGBUS`.
+	 * 
+	 * @param filename Name of the file to be opened.
+	 * @return Input stream of the opened file.
+	 */
+	[[nodiscard]] virtual std::shared_ptr<std::istream> map_read(std::filesystem::path const& filename) const = 0;
+
+	/**
+	 * @brief Reads whole contents of a file without opening a stream.
+	 * 
+	 * @param[in] filename Name of the file to be read.
+	 * @return Contents of the file.
+	 * 
+	 * @exception \ref std::filesystem::filesystem_error if \p filename is not a regular file or cannot be read.
+	 */
+	[[nodiscard]] virtual std::string read_file(std::filesystem::path const& filename) const = 0;
+
+	/**
+	 * @brief Reads whole contents of a file without opening a stream.
+	 * 
+	 * @param[in]  filename Name of the file to be read.
+	 * @param[out] ec       Error code to store error status to.
+	 * @return Contents of the file.
+	 */
+	[[nodiscard]] virtual std::string read_file(std::filesystem::path const& filename, std::error_code& ec) const noexcept = 0;
+
+	/**
+	 * @brief Reads a part of a file without opening a stream.
+	 * 
+	 * @param[in]  filename Name of the file to be read.
+	 * @param[in]  offset   Position in the file to read from.
+	 * @param[out] buf      Buffer to read into.
+	 * @return Number of bytes read, which is less than the size of \p buf only if the end of the file is reached.
+	 * 
+	 * @exception \ref std::filesystem::filesystem_error if \p filename is not a regular file or cannot be read.
+	 */
+	[[nodiscard]] virtual std::size_t read_at(std::filesystem::path const& filename, std::uintmax_t offset, std::span<char> buf) const = 0;
+
+	/**
+	 * @brief Reads a part of a file without opening a stream.
+	 * 
+	 * @param[in]  filename Name of the file to be read.
+	 * @param[in]  offset   Position in the file to read from.
+	 * @param[out] buf      Buffer to read into.
+	 * @param[out] ec       Error code to store error status to.
+	 * @return Number of bytes read, which is less than the size of \p buf only if the end of the file is reached.
+	 */
+	[[nodiscard]] virtual std::size_t read_at(std::filesystem::path const& filename, std::uintmax_t offset, std::span<char> buf, std::error_code& ec) const noexcept = 0;
+
+	/**
+	 * @brief Writes data to a file without opening a stream. The file is created if it does not exist.
+	 * 
+	 * @param[in] filename Name of the file to be written.
+	 * @param[in] data     Data to be written.
+	 * @param[in] mode     \ref std::ios_base::app to append \p data, otherwise the contents are replaced with \p data.
+	 * 
+	 * @exception \ref std::filesystem::filesystem_error if \p filename cannot be written or created.
+	 */
+	virtual void write_file(std::filesystem::path const& filename, std::string_view data, std::ios_base::openmode mode) = 0;
+
+	/**
+	 * @brief Replaces contents of a file without opening a stream. The file is created if it does not exist.
+	 * 
+	 * @param[in] filename Name of the file to be written.
+	 * @param[in] data     Data to be written.
+	 * 
+	 * @exception \ref std::filesystem::filesystem_error if \p filename cannot be written or created.
+	 */
+	void write_file(std::filesystem::path const& filename, std::string_view data) {
+		this->write_file(filename, data, std::ios_base::out);
+	}
+
+	/**
+	 * @brief Writes data to a file without opening a stream. The file is created if it does not exist.
+	 * 
+	 * @param[in]  filename Name of the file to be written.
+	 * @param[in]  data     Data to be written.
+	 * @param[in]  mode     \ref std::ios_base::app to append \p data, otherwise the contents are replaced with \p data.
+	 * @param[out] ec       Error code to store error status to.
+	 */
+	virtual void write_file(std::filesystem::path const& filename, std::string_view data, std::ios_base::openmode mode, std::error_code& ec) noexcept = 0;
+
+	/**
+	 * @brief Opens a regular file for reading at given offsets.
+	 * 
+	 * @param[in] filename Name of the file to be opened.
+	 * @return Handle of the opened file, which fails to write.
+	 * 
+	 * @exception \ref std::filesystem::filesystem_error if \p filename is not a regular file.
+	 */
+	[[nodiscard]] virtual std::shared_ptr<FileHandle> open_file(std::filesystem::path const& filename) const = 0;
+
+	/**
+	 * @brief Opens a regular file for reading and writing at given offsets.
+	 * 
+	 * @param[in] filename Name of the file to be opened.
+	 * @param[in] mode     Open mode for the file. With \ref std::ios_base::out, the file is created if it does not exist and the handle is writable.
+	 *   With \ref std::ios_base::trunc, the file is truncated as well.
+	 * @return Handle of the opened file.
+	 * 
+	 * @exception \ref std::filesystem::filesystem_error if \p filename is not a regular file or cannot be created.
+	 */
+	[[nodiscard]] virtual std::shared_ptr<FileHandle> open_file(std::filesystem::path const& filename, std::ios_base::openmode mode) = 0;
+
 	[[nodiscard]] virtual std::shared_ptr<Fs const> change_root(std::filesystem::path const& p, std::filesystem::path const& temp_dir) const = 0;
 
 	[[nodiscard]] std::shared_ptr<Fs const> change_root(std::filesystem::path const& p) const {
@@ -807,6 +1006,59 @@ class Fs: public std::enable_shared_from_this<Fs> {
 	 */
 	virtual std::filesystem::file_status symlink_status(std::filesystem::path const& p, std::error_code& ec) const noexcept = 0;
 
+	/**
+	 * @brief Retrieves the attributes of many files at once. Symbolic links are followed as \ref status does.
+	 *   Implementations share the work between the paths, e.g. a parent directory shared by consecutive paths is resolved once.
+	 * 
+	 * @param[in] ps Paths to the files for which the attributes are to be retrieved.
+	 * @return Attributes of the files in order of \p ps. A failure on a path is stored in its error instead of being thrown.
+	 */
+	[[nodiscard]] virtual FileStatuses status_many(std::span<std::filesystem::path const> ps) const = 0;
+
+	/**
+	 * @brief Reads whole contents of a file without blocking the caller.
+	 *   Files of the OS are read by a shared I/O engine, through io_uring where the kernel provides it,
+	 *   and \p callback is called on one of the threads of the engine.
+	 *   Other files are read on the calling thread and \p callback is called before this function returns.
+	 *   Paths are resolved on the calling thread.
+	 *   \p callback must not throw.
+	 *
+	 * @param[in] filename Path to the file to be read.
+	 * @param[in] callback Called with the error status and the contents of \p filename once the read completes.
+	 */
+	virtual void async_read_file(std::filesystem::path const& filename, std::function<void(std::error_code, std::string)> callback) const = 0;
+
+	/**
+	 * @brief Writes data to a file without blocking the caller, as \ref write_file does.
+	 *   \p callback is called as \ref async_read_file describes.
+	 *
+	 * @param[in] filename Path to the file to be written.
+	 * @param[in] data     Data to be written.
+	 * @param[in] mode     \ref std::ios_base::app to append \p data, otherwise the contents are replaced with \p data.
+	 * @param[in] callback Called with the error status once the write completes.
+	 */
+	virtual void async_write_file(std::filesystem::path const& filename, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) = 0;
+
+	/**
+	 * @brief Retrieves the status of a file without blocking the caller, as \ref status does.
+	 *   \p callback is called as \ref async_read_file describes.
+	 *
+	 * @param[in] p        Path to the file for which the status is to be retrieved.
+	 * @param[in] callback Called with the error status and the status of \p p once it is retrieved.
+	 */
+	virtual void async_status(std::filesystem::path const& p, std::function<void(std::error_code, std::filesystem::file_status)> callback) const = 0;
+
+	/**
+	 * @brief Copies files or directories without blocking the caller, as \ref copy does.
+	 *   \p callback is called as \ref async_read_file describes.
+	 *
+	 * @param[in] src      Path to the source file or directory.
+	 * @param[in] dst      Path to the destination file or directory.
+	 * @param[in] opts     Options for the copy operation.
+	 * @param[in] callback Called with the error status once the copy completes.
+	 */
+	virtual void async_copy(std::filesystem::path const& src, std::filesystem::path const& dst, std::filesystem::copy_options opts, std::function<void(std::error_code)> callback) = 0;
+
 	/**
 	 * @brief Retrieves the path to the temporary directory.
 	 * 
@@ -1154,13 +1406,60 @@ class Fs: public std::enable_shared_from_this<Fs> {
 std::shared_ptr<Fs> make_os_fs();
 
 /**
- * @brief Makes empty `Fs` that is virtual. Regular files are written to the temporary directory of the OS and are deleted when the `Fs` is destructed.
+ * @brief Options for `Fs` made by `make_vfs` and `make_mem_fs`.
+ */
+struct VfsOptions {
+	/**
+	 * @brief Remembers which file a path resolves to so that repeated lookups of the same path do not walk the directory tree again.
+	 * A cached path is invalidated when an entry of a directory it walks through is created, removed, or mounted through `Fs`.
+	 * Directories of an OS file system are tracked as a whole, so any change under such a mount invalidates the paths walking into it.
+	 * Changes made outside of `Fs`, e.g. directly on the OS file system under a mount point, are not observed.
+	 */
+	bool cache_lookups = false;
+
+	/**
+	 * @brief Maximum number of threads that copy contents of regular files on recursive `copy`.
+	 * Directories and files are created first in the order of traversal, and then their contents are copied by the threads.
+	 * Errors are reported as serial copy does. `0` or `1` copies serially.
+	 */
+	std::size_t copy_concurrency = 1;
+
+	/**
+	 * @brief Stores entries of each directory in an array sorted by name instead of a hash table.
+	 * It takes less memory per entry and lists entries in order of their names, but creating or removing an entry
+	 * costs linear time in the number of entries of the directory.
+	 */
+	bool sorted_directories = false;
+
+	/**
+	 * @brief Makes the `Fs` usable from multiple threads at once.
+	 * Each directory has its own reader/writer lock, so operations on different directories do not wait for each other,
+	 * and `rename` locks the source and destination directories together.
+	 * Mount points in directories on the OS and the hidden entries of union mounts are guarded by their own locks.
+	 * Readers of a regular file see the contents committed before they opened it; regular files on the OS follow the semantics of the OS.
+	 */
+	bool concurrent = false;
+};
+
+/**
+ * @brief Makes empty `Fs` that is virtual. Regular files are kept in memory until they grow large, and then moved to the temporary directory of the OS.
+ *   They are deleted when the `Fs` is destructed.
  * 
  * @param temp_dir Path to the temporary directory in the created `Fs`.
  * @return New empty `Fs` that is virtual.
  */
 std::shared_ptr<Fs> make_vfs(std::filesystem::path const& temp_dir = "/tmp");
 
+/**
+ * @brief Makes empty `Fs` that is virtual. Regular files are kept in memory until they grow large, and then moved to the temporary directory of the OS.
+ *   They are deleted when the `Fs` is destructed.
+ * 
+ * @param temp_dir Path to the temporary directory in the created `Fs`.
+ * @param opts Options for the created `Fs`.
+ * @return New empty `Fs` that is virtual.
+ */
+std::shared_ptr<Fs> make_vfs(std::filesystem::path const& temp_dir, VfsOptions const& opts);
+
 /**
  * @brief Makes empty `Fs` that is virtual. Regular files are stored on the memory.
  * 
@@ -1169,6 +1468,15 @@ std::shared_ptr<Fs> make_vfs(std::filesystem::path const& temp_dir = "/tmp");
  */
 std::shared_ptr<Fs> make_mem_fs(std::filesystem::path const& temp_dir = "/tmp");
 
+/**
+ * @brief Makes empty `Fs` that is virtual. Regular files are stored on the memory.
+ * 
+ * @param temp_dir Path to the temporary directory in the created `Fs`.
+ * @param opts Options for the created `Fs`.
+ * @return New empty `Fs` that is virtual.
+ */
+std::shared_ptr<Fs> make_mem_fs(std::filesystem::path const& temp_dir, VfsOptions const& opts);
+
 std::shared_ptr<Fs> make_union_fs(Fs& upper, Fs const& lower);
 
 /**
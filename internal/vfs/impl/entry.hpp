@@ -1,13 +1,17 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <string>
 #include <system_error>
 #include <utility>
+#include <vector>
 
 #include "vfs/impl/file.hpp"
+#include "vfs/impl/name.hpp"
 #include "vfs/impl/utils.hpp"
 
 namespace vfs {
@@ -20,7 +24,7 @@ class Entry: public std::enable_shared_from_this<Entry> {
 	virtual ~Entry() = default;
 
 	std::string const& name() const {
-		return this->name_;
+		return this->name_.str();
 	}
 
 	[[nodiscard]] bool holds(File const& file) const {
@@ -82,11 +86,11 @@ class Entry: public std::enable_shared_from_this<Entry> {
 	}
 
    private:
-	std::string name_;
+	Name name_;
 
    protected:
-	Entry(std::string name, std::shared_ptr<DirectoryEntry> prev)
-	    : name_(std::move(name))
+	Entry(std::string const& name, std::shared_ptr<DirectoryEntry> prev)
+	    : name_(name)
 	    , prev_(std::move(prev)) { }
 
 	std::shared_ptr<DirectoryEntry> prev_;
@@ -224,5 +228,58 @@ class UnknownTypeEntry: public Entry {
 	std::shared_ptr<File> file_;
 };
 
+// Files walked from an anchor directory entry.
+// `Entry`s are materialized only on demand by `entry()`, so resolving a path
+// costs no allocation per path component.
+class Trail {
+   public:
+	// Limit on the number of symlinks followed while resolving a single path.
+	static constexpr std::size_t MaxSymlinkHops = 40;
+
+	// `watch`, if given, is added with the directories looked into, including those reached by symlinks.
+	Trail(std::shared_ptr<DirectoryEntry const> anchor, ChangeWatch* watch = nullptr)
+	    : anchor_(std::move(anchor))
+	    , watch_(watch) { }
+
+	// Returns the last walked file.
+	[[nodiscard]] std::shared_ptr<File> file() const;
+
+	[[nodiscard]] std::filesystem::path path() const;
+
+	// Materializes the chain of `Entry` to the last walked file.
+	[[nodiscard]] std::shared_ptr<Entry const> entry() const;
+
+	// Walks given path; the last file is not followed if it is a symlink.
+	// `first` is left at the component where the walk stopped if exception is thrown,
+	// and the trail holds the last file successfully walked.
+	void walk(std::filesystem::path::const_iterator& first, std::filesystem::path::const_iterator last);
+
+	void walk(std::filesystem::path const& p) {
+		auto it = p.begin();
+		this->walk(it, p.end());
+	}
+
+	// Follows the last file until it is not a symlink.
+	// The trail is not changed if exception is thrown.
+	void follow_chain();
+
+   private:
+	struct Step {
+		std::string           name;
+		std::shared_ptr<File> file;
+	};
+
+	[[nodiscard]] File const* last_() const;
+
+	void pop_();
+
+	std::shared_ptr<DirectoryEntry const> anchor_;
+	std::vector<Step>                     steps_;
+
+	ChangeWatch* watch_;
+
+	std::size_t hops_ = 0;
+};
+
 }  // namespace impl
 }  // namespace vfs
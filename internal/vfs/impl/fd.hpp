@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cerrno>
+#include <filesystem>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace vfs {
+namespace impl {
+
+// File descriptor of the OS, closed when destructed.
+class Fd {
+   public:
+	// Throws if `p` cannot be opened.
+	Fd(std::filesystem::path const& p, int flags)
+	    : fd_(::open(p.c_str(), flags | O_CLOEXEC, 0666)) {
+		if(this->fd_ < 0) {
+			throw std::filesystem::filesystem_error("", p, std::error_code(errno, std::generic_category()));
+		}
+	}
+
+	// Takes `fd`, which is negative if there is none.
+	explicit Fd(int fd) noexcept
+	    : fd_(fd) { }
+
+	Fd(Fd const& other) = delete;
+	Fd(Fd&& other)      = delete;
+
+	~Fd() {
+		if(this->fd_ >= 0) {
+			::close(this->fd_);
+		}
+	}
+
+	Fd& operator=(Fd const& other) = delete;
+	Fd& operator=(Fd&& other)      = delete;
+
+	[[nodiscard]] int get() const noexcept {
+		return this->fd_;
+	}
+
+	explicit operator bool() const noexcept {
+		return this->fd_ >= 0;
+	}
+
+   private:
+	int fd_;
+};
+
+}  // namespace impl
+}  // namespace vfs
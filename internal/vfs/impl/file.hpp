@@ -1,18 +1,28 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <iosfwd>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+
+#include "vfs/impl/name.hpp"
+
+#include "vfs/fs.hpp"
 
 namespace vfs {
 namespace impl {
 
+class ChangeWatch;
+
 class File {
    public:
 	virtual ~File() = default;
@@ -57,7 +67,7 @@ class RegularFile: virtual public File {
 		return Type;
 	}
 
-	void copy_from(RegularFile const& other);
+	virtual void copy_from(RegularFile const& other);
 
 	[[nodiscard]] virtual std::uintmax_t size() const {
 		return static_cast<std::uintmax_t>(-1);
@@ -76,6 +86,26 @@ class RegularFile: virtual public File {
 	std::shared_ptr<std::ostream> open_write() {
 		return this->open_write(std::ios_base::out);
 	}
+
+	// Following functions are implemented with streams by default.
+	// Backends override them to skip the streams.
+
+	// Stream over a memory mapping of the contents, which only OS files have.
+	[[nodiscard]] virtual std::shared_ptr<std::istream> map_read() const {
+		return this->open_read(std::ios_base::in);
+	}
+
+	[[nodiscard]] virtual std::string read_all() const;
+
+	// Returns the number of bytes read, which is less than `buf.size()` only if the end of the file is reached.
+	[[nodiscard]] virtual std::size_t read_at(std::uintmax_t offset, std::span<char> buf) const;
+
+	// Appends `data` if `mode` has `std::ios_base::app`, or replaces the contents otherwise.
+	virtual void write_all(std::string_view data, std::ios_base::openmode mode);
+
+	// Returned handle is writable only if `mode` has `std::ios_base::out`,
+	// and the file is truncated if `mode` has `std::ios_base::trunc`.
+	[[nodiscard]] virtual std::shared_ptr<FileHandle> open_handle(std::ios_base::openmode mode) = 0;
 };
 
 class Symlink: virtual public File {
@@ -133,7 +163,7 @@ class Directory: virtual public File {
 	class StaticCursor: public Cursor {
 	   public:
 		StaticCursor(std::unordered_map<std::string, std::shared_ptr<File>> const& files);
-		StaticCursor(std::unordered_map<std::string, std::shared_ptr<File>>&& files);
+		StaticCursor(std::vector<std::pair<Name, std::shared_ptr<File>>> files);
 
 		[[nodiscard]] std::string const& name() const override;
 
@@ -144,10 +174,9 @@ class Directory: virtual public File {
 		[[nodiscard]] bool at_end() const override;
 
 	   private:
-		std::unordered_map<std::string, std::shared_ptr<File>> files_;
+		std::vector<std::pair<Name, std::shared_ptr<File>>> files_;
 
-		std::unordered_map<std::string, std::shared_ptr<File>>::const_iterator it_;
-		std::unordered_map<std::string, std::shared_ptr<File>>::const_iterator end_;
+		std::vector<std::pair<Name, std::shared_ptr<File>>>::const_iterator it_;
 	};
 
 	struct Iterator {
@@ -210,8 +239,17 @@ class Directory: virtual public File {
 
 	virtual std::uintmax_t clear() = 0;
 
+	// Moves the entry `name` to `dst` as `dst_name`, replacing the existing one, at once with respect to other operations on both directories.
+	// Returns false if it is not supported between the directories; the caller links and unlinks then.
+	virtual bool move(std::string const& /*name*/, Directory& /*dst*/, std::string const& /*dst_name*/) {
+		return false;
+	}
+
 	[[nodiscard]] virtual std::shared_ptr<Cursor> cursor() const = 0;
 
+	// Adds the counters of changes that affect the entries of this directory; see `LookupCache`.
+	virtual void watch_changes(ChangeWatch& watch) const = 0;
+
 	[[nodiscard]] Iterator begin() const {
 		return this->empty()
 		    ? Iterator()
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 #include "vfs/impl/file.hpp"
@@ -89,6 +92,10 @@ class RegularFileProxy: public TypedFileProxy<RegularFile, Storage> {
 	RegularFileProxy(std::shared_ptr<Storage> origin)
 	    : TypedFileProxy<RegularFile, Storage>(std::move(origin)) { }
 
+	void copy_from(RegularFile const& other) override {
+		this->mutable_origin_()->copy_from(other);
+	}
+
 	[[nodiscard]] std::uintmax_t size() const override {
 		return this->origin_->size();
 	}
@@ -104,6 +111,31 @@ class RegularFileProxy: public TypedFileProxy<RegularFile, Storage> {
 	std::shared_ptr<std::ostream> open_write(std::ios_base::openmode mode) override {
 		return this->mutable_origin_()->open_write(mode);
 	}
+
+	[[nodiscard]] std::shared_ptr<std::istream> map_read() const override {
+		return this->origin_->map_read();
+	}
+
+	[[nodiscard]] std::string read_all() const override {
+		return this->origin_->read_all();
+	}
+
+	[[nodiscard]] std::size_t read_at(std::uintmax_t offset, std::span<char> buf) const override {
+		return this->origin_->read_at(offset, buf);
+	}
+
+	void write_all(std::string_view data, std::ios_base::openmode mode) override {
+		this->mutable_origin_()->write_all(data, mode);
+	}
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_handle(std::ios_base::openmode mode) override {
+		if((mode & std::ios_base::out) == 0) {
+			// Read-only handle does not modify the origin.
+			return std::const_pointer_cast<std::remove_const_t<Storage>>(this->origin_)->open_handle(mode);
+		}
+
+		return this->mutable_origin_()->open_handle(mode);
+	}
 };
 
 template<std::derived_from<Directory> Storage = Directory>
@@ -125,6 +157,10 @@ class DirectoryProxy: public TypedFileProxy<Directory, Storage> {
 		return this->origin_->next(name);
 	}
 
+	void watch_changes(ChangeWatch& watch) const override {
+		this->origin_->watch_changes(watch);
+	}
+
 	std::pair<std::shared_ptr<RegularFile>, bool> emplace_regular_file(std::string const& name) override {
 		return this->mutable_origin_()->emplace_regular_file(name);
 	}
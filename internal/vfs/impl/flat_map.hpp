@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "vfs/impl/name.hpp"
+
+namespace vfs {
+namespace impl {
+
+// Map from names to `T` that stores its entries in a vector sorted by name.
+// Compared to `std::unordered_map`, an entry costs no node allocation, lookup is a binary search over contiguous memory,
+// and iteration is in order of names.
+// Insertion and removal are linear, which is fine for directories that have tens to thousands of entries.
+template<typename T>
+class FlatMap {
+   public:
+	using key_type       = Name;
+	using mapped_type    = T;
+	using value_type     = std::pair<Name, T>;
+	using iterator       = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
+
+	[[nodiscard]] bool empty() const noexcept {
+		return this->entries_.empty();
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept {
+		return this->entries_.size();
+	}
+
+	[[nodiscard]] iterator begin() noexcept {
+		return this->entries_.begin();
+	}
+
+	[[nodiscard]] iterator end() noexcept {
+		return this->entries_.end();
+	}
+
+	[[nodiscard]] const_iterator begin() const noexcept {
+		return this->entries_.begin();
+	}
+
+	[[nodiscard]] const_iterator end() const noexcept {
+		return this->entries_.end();
+	}
+
+	[[nodiscard]] std::vector<value_type> const& entries() const noexcept {
+		return this->entries_;
+	}
+
+	[[nodiscard]] iterator find(std::string_view key) {
+		return find_(this->entries_, key);
+	}
+
+	[[nodiscard]] const_iterator find(std::string_view key) const {
+		return find_(this->entries_, key);
+	}
+
+	[[nodiscard]] bool contains(std::string_view key) const {
+		return this->find(key) != this->end();
+	}
+
+	// Unlike `std::unordered_map::emplace`, `T` is not constructed if `key` exists.
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(std::string_view key, Args&&... args) {
+		auto const it = lower_bound_(this->entries_, key);
+		if(it != this->entries_.end() && it->first == key) {
+			return std::make_pair(it, false);
+		}
+
+		auto const inserted = this->entries_.emplace(it, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		return std::make_pair(inserted, true);
+	}
+
+	iterator erase(const_iterator pos) {
+		return this->entries_.erase(pos);
+	}
+
+	std::size_t erase(std::string_view key) {
+		auto const it = this->find(key);
+		if(it == this->entries_.end()) {
+			return 0;
+		}
+
+		this->entries_.erase(it);
+		return 1;
+	}
+
+	void clear() noexcept {
+		this->entries_.clear();
+	}
+
+   private:
+	template<typename Entries>
+	static auto lower_bound_(Entries& entries, std::string_view key) {
+		return std::lower_bound(entries.begin(), entries.end(), key, [](value_type const& entry, std::string_view key) {
+			return std::string_view(entry.first) < key;
+		});
+	}
+
+	template<typename Entries>
+	static auto find_(Entries& entries, std::string_view key) {
+		auto const it = lower_bound_(entries, key);
+		return (it != entries.end() && it->first == key) ? it : entries.end();
+	}
+
+	std::vector<value_type> entries_;
+};
+
+}  // namespace impl
+}  // namespace vfs
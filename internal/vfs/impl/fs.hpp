@@ -1,9 +1,16 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <type_traits>
 
 #include "vfs/impl/file.hpp"
@@ -13,6 +20,10 @@
 
 #define VFS_FS_METHOD_NAMES      \
 	Fs::canonical,               \
+	    Fs::async_copy,          \
+	    Fs::async_read_file,     \
+	    Fs::async_status,        \
+	    Fs::async_write_file,    \
 	    Fs::weakly_canonical,    \
 	    Fs::copy,                \
 	    Fs::copy_file,           \
@@ -25,7 +36,11 @@
 	    Fs::file_size,           \
 	    Fs::hard_link_count,     \
 	    Fs::last_write_time,     \
+	    Fs::map_read,            \
+	    Fs::open_file,           \
 	    Fs::permissions,         \
+	    Fs::read_at,             \
+	    Fs::read_file,           \
 	    Fs::read_symlink,        \
 	    Fs::remove,              \
 	    Fs::remove_all,          \
@@ -33,8 +48,10 @@
 	    Fs::resize_file,         \
 	    Fs::space,               \
 	    Fs::status,              \
+	    Fs::status_many,         \
 	    Fs::symlink_status,      \
 	    Fs::temp_directory_path, \
+	    Fs::write_file,          \
 	    Fs::is_empty
 
 namespace vfs {
@@ -116,6 +133,14 @@ class FsBase: public Fs {
 		handle_error([&] { this->permissions(p, prms, opts); return 0; }, ec);
 	}
 
+	[[nodiscard]] std::size_t read_at(std::filesystem::path const& filename, std::uintmax_t offset, std::span<char> buf, std::error_code& ec) const noexcept override {
+		return handle_error([&] { return this->read_at(filename, offset, buf); }, ec);
+	}
+
+	[[nodiscard]] std::string read_file(std::filesystem::path const& filename, std::error_code& ec) const noexcept override {
+		return handle_error([&] { return this->read_file(filename); }, ec);
+	}
+
 	[[nodiscard]] std::filesystem::path read_symlink(std::filesystem::path const& p, std::error_code& ec) const override {
 		return handle_error([&] { return this->read_symlink(p); }, ec);
 	}
@@ -148,10 +173,26 @@ class FsBase: public Fs {
 		return handle_error([&] { return this->symlink_status(p); }, ec);
 	}
 
+	// Queries each path one by one; implementations override it to share the work between the paths.
+	[[nodiscard]] FileStatuses status_many(std::span<std::filesystem::path const> ps) const override;
+
+	// Completes on the calling thread; implementations whose I/O blocks override them to run on `IoEngine`.
+	void async_read_file(std::filesystem::path const& filename, std::function<void(std::error_code, std::string)> callback) const override;
+
+	void async_write_file(std::filesystem::path const& filename, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) override;
+
+	void async_status(std::filesystem::path const& p, std::function<void(std::error_code, std::filesystem::file_status)> callback) const override;
+
+	void async_copy(std::filesystem::path const& src, std::filesystem::path const& dst, std::filesystem::copy_options opts, std::function<void(std::error_code)> callback) override;
+
 	[[nodiscard]] std::filesystem::path temp_directory_path(std::error_code& ec) const override {
 		return handle_error([&] { return this->temp_directory_path(); }, ec);
 	}
 
+	void write_file(std::filesystem::path const& filename, std::string_view data, std::ios_base::openmode mode, std::error_code& ec) noexcept override {
+		handle_error([&] { this->write_file(filename, data, mode); return 0; }, ec);
+	}
+
 	[[nodiscard]] bool is_empty(std::filesystem::path const& p, std::error_code& ec) const override {
 		return handle_error([&] { return this->is_empty(p); }, ec);
 	}
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <iosfwd>
 #include <memory>
+#include <span>
+#include <string>
+#include <string_view>
 #include <system_error>
 #include <type_traits>
 #include <utility>
@@ -31,6 +36,34 @@ class BasicFsProxy: public FsBase {
 		return this->mutable_fs_()->open_write(filename, mode);
 	}
 
+	[[nodiscard]] std::shared_ptr<std::istream> map_read(std::filesystem::path const& filename) const override {
+		return this->fs_->map_read(filename);
+	}
+
+	[[nodiscard]] std::string read_file(std::filesystem::path const& filename) const override {
+		return this->fs_->read_file(filename);
+	}
+
+	[[nodiscard]] std::size_t read_at(std::filesystem::path const& filename, std::uintmax_t offset, std::span<char> buf) const override {
+		return this->fs_->read_at(filename, offset, buf);
+	}
+
+	void write_file(std::filesystem::path const& filename, std::string_view data, std::ios_base::openmode mode) override {
+		this->mutable_fs_()->write_file(filename, data, mode);
+	}
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_file(std::filesystem::path const& filename) const override {
+		return this->fs_->open_file(filename);
+	}
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_file(std::filesystem::path const& filename, std::ios_base::openmode mode) override {
+		if((mode & std::ios_base::out) == 0) {
+			return this->fs_->open_file(filename);
+		}
+
+		return this->mutable_fs_()->open_file(filename, mode);
+	}
+
 	[[nodiscard]] std::shared_ptr<Fs const> change_root(std::filesystem::path const& p, std::filesystem::path const& temp_dir) const override {
 		auto fs = this->fs_->change_root(p, temp_dir);
 		return this->make_proxy_(std::move(fs));
@@ -153,6 +186,34 @@ class BasicFsProxy: public FsBase {
 		return this->fs_->symlink_status(p);
 	}
 
+	[[nodiscard]] FileStatuses status_many(std::span<std::filesystem::path const> ps) const override {
+		return this->fs_->status_many(ps);
+	}
+
+	void async_read_file(std::filesystem::path const& filename, std::function<void(std::error_code, std::string)> callback) const override {
+		this->fs_->async_read_file(filename, std::move(callback));
+	}
+
+	void async_write_file(std::filesystem::path const& filename, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) override {
+		if constexpr(std::is_const_v<T>) {
+			callback(std::make_error_code(std::errc::read_only_file_system));
+		} else {
+			this->fs_->async_write_file(filename, std::move(data), mode, std::move(callback));
+		}
+	}
+
+	void async_status(std::filesystem::path const& p, std::function<void(std::error_code, std::filesystem::file_status)> callback) const override {
+		this->fs_->async_status(p, std::move(callback));
+	}
+
+	void async_copy(std::filesystem::path const& src, std::filesystem::path const& dst, std::filesystem::copy_options opts, std::function<void(std::error_code)> callback) override {
+		if constexpr(std::is_const_v<T>) {
+			callback(std::make_error_code(std::errc::read_only_file_system));
+		} else {
+			this->fs_->async_copy(src, dst, opts, std::move(callback));
+		}
+	}
+
 	[[nodiscard]] std::filesystem::path temp_directory_path() const override {
 		return this->fs_->temp_directory_path();
 	}
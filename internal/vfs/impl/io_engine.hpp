@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace vfs {
+namespace impl {
+
+// Runs I/O of OS files for `Fs::async_*`, so callers are not blocked.
+// Reads, writes, and status queries go through an io_uring where the kernel provides one,
+// so a file waiting on the disk does not hold a thread; other jobs run on a pool of threads,
+// as do the queries if there is no io_uring.
+// Callbacks are called on the pool in any order.
+// Jobs still queued when the engine is destructed are dropped.
+class IoEngine {
+   public:
+	explicit IoEngine(std::size_t concurrency);
+
+	IoEngine(IoEngine const& other) = delete;
+	IoEngine(IoEngine&& other)      = delete;
+
+	~IoEngine();
+
+	IoEngine& operator=(IoEngine const& other) = delete;
+	IoEngine& operator=(IoEngine&& other)      = delete;
+
+	// Shared by every file system; runs at least a few threads since the jobs mostly wait on the kernel.
+	static IoEngine& instance();
+
+	// `job` must not throw.
+	void submit(std::function<void()> job);
+
+	// Reads whole contents of the OS file at `p` as `read_os_file` does.
+	void read_file(std::filesystem::path p, std::function<void(std::error_code, std::string)> callback);
+
+	// Writes `data` to the OS file at `p` as `write_os_file` does.
+	void write_file(std::filesystem::path p, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback);
+
+	// Retrieves the status of the OS file at `p` as `std::filesystem::status` does, but a missing file is not an error.
+	void status(std::filesystem::path p, std::function<void(std::error_code, std::filesystem::file_status)> callback);
+
+   private:
+	class Ring_;
+
+	struct Reading_;
+	struct Writing_;
+
+	void run_(std::stop_token const& stop);
+
+	void read_(std::shared_ptr<Reading_> r);
+	void write_(std::shared_ptr<Writing_> w);
+
+	std::mutex                        mutex_;
+	std::condition_variable_any       cv_;
+	std::deque<std::function<void()>> jobs_;
+
+	// Null if the kernel provides no io_uring.
+	// Destructed after the threads are joined but before the queue, as it queues the callbacks.
+	std::unique_ptr<Ring_> ring_;
+
+	// Declared last so the threads are joined before the queue is destructed.
+	std::vector<std::jthread> workers_;
+};
+
+}  // namespace impl
+}  // namespace vfs
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include "vfs/impl/utils.hpp"
+
+namespace vfs {
+namespace impl {
+
+class File;
+
+// Counts changes of entries in the directories that share it.
+// Directories whose files are made on each lookup, e.g. `OsDirectory`, share one counter per tree
+// since a change made through one of them must be seen through the others.
+class ChangeCounter {
+   public:
+	void notify_inserted() noexcept {
+		this->insertions_.fetch_add(1);
+	}
+
+	void notify_removed() noexcept {
+		this->removals_.fetch_add(1);
+	}
+
+	[[nodiscard]] std::uint64_t insertions() const noexcept {
+		return this->insertions_.load();
+	}
+
+	[[nodiscard]] std::uint64_t removals() const noexcept {
+		return this->removals_.load();
+	}
+
+   private:
+	std::atomic<std::uint64_t> insertions_ = 0;
+	std::atomic<std::uint64_t> removals_   = 0;
+};
+
+// Counters of the directories a lookup walked through, read before each directory is looked into.
+class ChangeWatch {
+   public:
+	void add(std::shared_ptr<ChangeCounter const> counter);
+
+	// A removal may change where any lookup through the directory resolves to.
+	[[nodiscard]] bool removed() const noexcept;
+
+	// An insertion can only make a failed lookup succeed.
+	[[nodiscard]] bool changed() const noexcept;
+
+   private:
+	struct Entry_ {
+		std::shared_ptr<ChangeCounter const> counter;
+
+		std::uint64_t insertions;
+		std::uint64_t removals;
+	};
+
+	std::vector<Entry_> entries_;
+};
+
+// Remembers which file a path resolved to, so repeated lookups of the same path
+// do not walk the directory tree again.
+//
+// Each record watches the directories its lookup walked through, including those reached by symlinks,
+// and is dropped once one of them reports a change that may affect the lookup.
+// So changes in unrelated directories, or in other file systems, keep the record.
+// Changes made outside of the directories, e.g. directly on the OS file system, are not observed.
+class LookupCache {
+   public:
+	// Drops every record when this many are held, so paths looked up once do not pile up.
+	static constexpr std::size_t MaxRecords = 64 * 1024;
+
+	// Guards the records with a reader/writer lock if `concurrent`.
+	explicit LookupCache(bool concurrent = false)
+	    : mutex_(concurrent) { }
+
+	struct Record {
+		// Weak so that the cache neither keeps removed files alive nor counts as a hard link.
+		std::weak_ptr<File> file;
+
+		// Set if the lookup failed.
+		std::error_code    ec;
+		std::exception_ptr error;
+	};
+
+	// Returns a copy since the record may be replaced by other threads.
+	[[nodiscard]] std::optional<Record> find(std::string_view key, bool followed) const;
+
+	// `watch` is of the lookup that resolved `file`; the record is not inserted if it is already stale.
+	void insert(std::string_view key, bool followed, std::shared_ptr<File> const& file, ChangeWatch watch);
+
+	void insert(std::string_view key, bool followed, std::error_code ec, std::exception_ptr error, ChangeWatch watch);
+
+   private:
+	struct Hash_ {
+		using is_transparent = void;
+
+		std::size_t operator()(std::string_view key) const noexcept {
+			return std::hash<std::string_view>{}(key);
+		}
+	};
+
+	struct Entry_ {
+		Record      record;
+		ChangeWatch watch;
+	};
+
+	using Records_ = std::unordered_map<std::string, Entry_, Hash_, std::equal_to<>>;
+
+	Records_& records_of_(bool followed) {
+		return followed ? this->followed_records_ : this->records_;
+	}
+
+	Records_ const& records_of_(bool followed) const {
+		return followed ? this->followed_records_ : this->records_;
+	}
+
+	void insert_(std::string_view key, bool followed, Entry_ entry);
+
+	Records_ records_;
+	Records_ followed_records_;
+
+	mutable OptionalSharedMutex mutex_;
+};
+
+}  // namespace impl
+}  // namespace vfs
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <iosfwd>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 
 #include "vfs/impl/file.hpp"
 #include "vfs/impl/vfile.hpp"
@@ -12,6 +16,72 @@
 namespace vfs {
 namespace impl {
 
+// Contents of a regular file as fixed-size pages that are shared between copies.
+// Page `i` holds bytes from `i * PageSize`, so every page except the last one is full.
+// A shared page is copied before it is written.
+//
+// Full pages are kept in a spine shared by copies, which a copy appends to in place
+// unless another copy already appended there, so copying and then appending does not copy every page.
+class PagedBuffer {
+   public:
+	static constexpr std::size_t PageSize = 64 * 1024;
+
+	[[nodiscard]] std::size_t size() const noexcept {
+		return this->size_;
+	}
+
+	[[nodiscard]] std::size_t page_count() const noexcept {
+		return (this->size_ + PageSize - 1) / PageSize;
+	}
+
+	[[nodiscard]] std::string_view page(std::size_t i) const;
+
+	// Copies bytes from `offset` into `buf` and returns the number of bytes copied.
+	std::size_t read(std::size_t offset, std::span<char> buf) const;
+
+	// Returns writable space right after the end, which is not a part of the data until `grow` is called.
+	// The space is at least one byte but may be smaller than `n`.
+	[[nodiscard]] std::span<char> reserve(std::size_t n);
+
+	void grow(std::size_t n);
+
+	void append(std::string_view data);
+
+	// Overwrites bytes from `offset`, growing the buffer as needed; a gap before `offset` is filled with zeros.
+	void write(std::size_t offset, std::string_view data);
+
+	// Shares the pages of `other` if this buffer ends at a page boundary.
+	void append(PagedBuffer const& other);
+
+	void resize(std::size_t n);
+
+   private:
+	class Spine_;
+
+	static constexpr std::size_t MinPageCapacity_ = 256;
+
+	[[nodiscard]] std::size_t full_page_count_() const noexcept {
+		return this->size_ / PageSize;
+	}
+
+	// Appends the page that just became full to the spine.
+	void seal_(std::shared_ptr<std::string> page);
+
+	// Replaces full page `i`, which may be seen by copies.
+	void replace_(std::size_t i, std::shared_ptr<std::string> page);
+
+	// Makes a spine owned only by this buffer from the first `n` pages.
+	void fork_(std::size_t n);
+
+	// Holds `full_page_count_()` full pages; copies may hold more.
+	std::shared_ptr<Spine_> spine_;
+
+	// The last page if it is not full, which may be allocated smaller than `PageSize`.
+	std::shared_ptr<std::string> tail_;
+
+	std::size_t size_ = 0;
+};
+
 class MemRegularFile
     : public VFile
     , public RegularFile
@@ -23,16 +93,19 @@ class MemRegularFile
 	    : MemRegularFile(RegularFile::DefaultPerms) { }
 
 	MemRegularFile(MemRegularFile const& other);
-	MemRegularFile(MemRegularFile&& other) = default;
+	MemRegularFile(MemRegularFile&& other) noexcept;
 
 	[[nodiscard]] std::filesystem::file_time_type last_write_time() const override {
-		return this->last_write_time_;
+		return this->last_write_time_.load(std::memory_order_relaxed);
 	}
 
 	void last_write_time(std::filesystem::file_time_type new_time) override {
-		this->last_write_time_ = new_time;
+		this->last_write_time_.store(new_time, std::memory_order_relaxed);
 	}
 
+	// Shares the data if `other` is `MemRegularFile`.
+	void copy_from(RegularFile const& other) override;
+
 	[[nodiscard]] std::uintmax_t size() const override;
 
 	void resize(std::uintmax_t new_size) override;
@@ -41,30 +114,55 @@ class MemRegularFile
 
 	std::shared_ptr<std::ostream> open_write(std::ios_base::openmode mode) override;
 
+	[[nodiscard]] std::string read_all() const override;
+
+	[[nodiscard]] std::size_t read_at(std::uintmax_t offset, std::span<char> buf) const override;
+
+	void write_all(std::string_view data, std::ios_base::openmode mode) override;
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_handle(std::ios_base::openmode mode) override;
+
 	MemRegularFile& operator=(MemRegularFile const& other);
-	MemRegularFile& operator=(MemRegularFile&& other) = default;
+	MemRegularFile& operator=(MemRegularFile&& other) noexcept;
 
    private:
-	std::shared_ptr<std::string>    data_;
-	std::filesystem::file_time_type last_write_time_ = std::filesystem::file_time_type::clock::now();
+	class WriteBuf_;
+	class Handle_;
+
+	// Applies `f` to a copy of the current snapshot and publishes the copy.
+	// Pages are shared with the current snapshot and copied only when `f` writes them.
+	template<typename F>
+	void update_(F const& f);
+
+	// Published snapshot that is never modified, so readers take it without waiting for writers.
+	std::atomic<std::shared_ptr<PagedBuffer const>> data_;
+
+	std::atomic<std::filesystem::file_time_type> last_write_time_ = std::filesystem::file_time_type::clock::now();
 };
 
-class MemDirectory
-    : public VDirectory {
+template<typename Files>
+class BasicMemDirectory
+    : public BasicVDirectory<Files> {
    public:
-	MemDirectory(std::filesystem::perms perms)
-	    : VDirectory(perms) { }
+	BasicMemDirectory(std::filesystem::perms perms, bool concurrent = false)
+	    : BasicVDirectory<Files>(perms, concurrent) { }
 
-	MemDirectory()
-	    : VDirectory(DefaultPerms) { }
+	BasicMemDirectory()
+	    : BasicVDirectory<Files>(Directory::DefaultPerms) { }
 
-	MemDirectory(MemDirectory const& other) = default;
-	MemDirectory(MemDirectory&& other)      = default;
+	BasicMemDirectory(BasicMemDirectory const& other) = default;
+	BasicMemDirectory(BasicMemDirectory&& other)      = default;
 
 	std::pair<std::shared_ptr<RegularFile>, bool> emplace_regular_file(std::string const& name) override;
 
 	std::pair<std::shared_ptr<Directory>, bool> emplace_directory(std::string const& name) override;
 };
 
+extern template class BasicMemDirectory<HashedFiles>;
+extern template class BasicMemDirectory<SortedFiles>;
+
+using MemDirectory       = BasicMemDirectory<HashedFiles>;
+using SortedMemDirectory = BasicMemDirectory<SortedFiles>;
+
 }  // namespace impl
 }  // namespace vfs
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace vfs {
+namespace impl {
+
+// Name of a file interned in a process-wide table.
+// Equal names share one string, so they are compared by address and hashed without reading the string.
+// The string is released when the last `Name` of it is destructed.
+// A name already interned costs a shared lock and no allocation; a new one costs one allocation
+// unless the string does not fit in `std::string` itself.
+//
+// `Hash` and `std::equal_to<>` also accept `std::string_view`, so containers keyed by `Name`
+// can be searched by plain strings without interning them.
+class Name {
+   public:
+	struct Hash {
+		using is_transparent = void;
+
+		std::size_t operator()(Name const& name) const noexcept {
+			return name.rep_->hash;
+		}
+
+		std::size_t operator()(std::string_view name) const noexcept {
+			return std::hash<std::string_view>{}(name);
+		}
+	};
+
+	explicit Name(std::string_view name);
+
+	Name(Name const& other) noexcept
+	    : rep_(other.rep_) {
+		this->rep_->refs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Name(Name&& other) noexcept
+	    : rep_(std::exchange(other.rep_, nullptr)) { }
+
+	~Name() {
+		if(this->rep_ != nullptr) {
+			release_(this->rep_);
+		}
+	}
+
+	Name& operator=(Name const& other) noexcept {
+		Name(other).swap(*this);
+		return *this;
+	}
+
+	Name& operator=(Name&& other) noexcept {
+		Name(std::move(other)).swap(*this);
+		return *this;
+	}
+
+	void swap(Name& other) noexcept {
+		std::swap(this->rep_, other.rep_);
+	}
+
+	[[nodiscard]] std::string const& str() const noexcept {
+		return this->rep_->str;
+	}
+
+	operator std::string_view() const noexcept {
+		return this->rep_->str;
+	}
+
+	friend bool operator==(Name const& lhs, Name const& rhs) noexcept {
+		return lhs.rep_ == rhs.rep_;
+	}
+
+	friend bool operator==(Name const& lhs, std::string_view rhs) noexcept {
+		return std::string_view(lhs.rep_->str) == rhs;
+	}
+
+   private:
+	// Counted in place so that interning allocates it alone.
+	struct Rep_ {
+		std::string str;
+		std::size_t hash;
+
+		mutable std::atomic<std::size_t> refs = 1;
+	};
+
+	class Table_;
+
+	static void release_(Rep_ const* rep) noexcept;
+
+	Rep_ const* rep_;
+};
+
+}  // namespace impl
+}  // namespace vfs
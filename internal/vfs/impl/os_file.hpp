@@ -1,23 +1,164 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <unordered_map>
 #include <utility>
 
 #include "vfs/impl/file.hpp"
+#include "vfs/impl/lookup_cache.hpp"
 #include "vfs/impl/mount_point.hpp"
 #include "vfs/impl/utils.hpp"
 
 namespace vfs {
 namespace impl {
 
+// Regular files of at least this size are mapped by `map_os_read`.
+constexpr std::uintmax_t MinMappedReadSize = 64 * 1024;
+
+// Opens `p` for reading by mapping it into memory if it is a regular file of at least `MinMappedReadSize` bytes,
+// or by `std::ifstream` otherwise.
+// A mapped stream reads the contents in place, so pages are shared with the page cache and other processes.
+// Like any mapping, truncating the file by others while it is read raises SIGBUS,
+// so it is used only where callers ask for it.
+[[nodiscard]] std::shared_ptr<std::istream> map_os_read(std::filesystem::path const& p);
+
+// Attributes of a file read by one `stat`, following a symbolic link.
+// `type` is `std::filesystem::file_type::not_found` if the file does not exist.
+struct OsStat {
+	std::filesystem::file_type      type;
+	std::filesystem::perms          perms;
+	std::uintmax_t                  size;
+	std::filesystem::file_time_type last_write_time;
+};
+
+// Type of a file by the `st_mode` of its `stat`.
+[[nodiscard]] std::filesystem::file_type os_file_type_of(unsigned mode) noexcept;
+
+// Reads `OsStat` of `p` by one system call.
+// `ec` is set only if the attributes cannot be read for a reason other than `p` not existing.
+[[nodiscard]] OsStat stat_os_file(std::filesystem::path const& p, std::error_code& ec) noexcept;
+
+// Keeps `OsStat` of a file for `Ttl` so successive queries on the file cost one system call.
+// Writes through `OsFile` clear it; changes made by others are seen after `Ttl` at most.
+class OsStatCache {
+   public:
+	static constexpr std::chrono::steady_clock::duration Ttl = std::chrono::seconds(1);
+
+	[[nodiscard]] OsStat get(std::filesystem::path const& p);
+
+	void set(OsStat const& stat);
+
+	void clear() noexcept {
+		this->entry_.store(nullptr, std::memory_order_release);
+	}
+
+	// Clears the cache on both sides of a mutation made in its scope,
+	// so a query racing with the mutation does not keep the attributes from before it.
+	// Does nothing if `cache` is null.
+	class Invalidation {
+	   public:
+		explicit Invalidation(OsStatCache* cache) noexcept
+		    : cache_(cache) {
+			this->clear_();
+		}
+
+		Invalidation(Invalidation const& other) = delete;
+		Invalidation(Invalidation&& other)      = delete;
+
+		~Invalidation() {
+			this->clear_();
+		}
+
+		Invalidation& operator=(Invalidation const& other) = delete;
+		Invalidation& operator=(Invalidation&& other)      = delete;
+
+	   private:
+		void clear_() const noexcept {
+			if(this->cache_ != nullptr) {
+				this->cache_->clear();
+			}
+		}
+
+		OsStatCache* cache_;
+	};
+
+   private:
+	struct Entry_ {
+		OsStat stat;
+
+		std::chrono::steady_clock::time_point expires;
+	};
+
+	std::atomic<std::shared_ptr<Entry_ const>> entry_;
+};
+
+// Followings access `p` by system calls on a descriptor without streams.
+
+[[nodiscard]] std::string read_os_file(std::filesystem::path const& p);
+
+[[nodiscard]] std::size_t read_os_file_at(std::filesystem::path const& p, std::uintmax_t offset, std::span<char> buf);
+
+void write_os_file(std::filesystem::path const& p, std::string_view data, std::ios_base::openmode mode);
+
+// `stat` is cleared by writes through the handle.
+[[nodiscard]] std::shared_ptr<FileHandle> open_os_file(std::filesystem::path const& p, std::ios_base::openmode mode, std::shared_ptr<OsStatCache> stat = nullptr);
+
 class OsFile: virtual public File {
    public:
-	struct Context {
-		std::unordered_map<std::filesystem::path, std::shared_ptr<MountPoint>, PathHash> mount_points;
+	// Shared by the files of a tree, so its mount points are guarded by its own lock.
+	class Context {
+	   public:
+		using MountPoints = std::unordered_map<std::filesystem::path, std::shared_ptr<MountPoint>, PathHash>;
+
+		// Returns nullptr if `p` is not a mount point.
+		[[nodiscard]] std::shared_ptr<MountPoint> mount_point_at(std::filesystem::path const& p) const;
+
+		// Returns true if `p` or any file under `p` is a mount point.
+		[[nodiscard]] bool has_mount_point_within(std::filesystem::path const& p) const;
+
+		// Returns true if `pred` holds for the path of any mount point.
+		template<typename F>
+		[[nodiscard]] bool any_mount_point(F const& pred) const {
+			if(this->size_.load(std::memory_order_acquire) == 0) {
+				return false;
+			}
+
+			std::shared_lock const lock(this->mutex_);
+			return std::any_of(this->mount_points_.begin(), this->mount_points_.end(), [&](auto const& entry) { return pred(entry.first); });
+		}
+
+		// Calls `f` with the mount points while no other thread reads them.
+		template<typename F>
+		void update_mount_points(F const& f) {
+			std::unique_lock const lock(this->mutex_);
+			f(this->mount_points_);
+			this->size_.store(this->mount_points_.size(), std::memory_order_release);
+		}
+
+		// Shared by the directories of the tree since each lookup makes new ones.
+		ChangeCounter changes;
+
+	   private:
+		mutable std::shared_mutex mutex_;
+
+		MountPoints mount_points_;
+
+		// Read without the lock so that trees without mount points do not take it on each lookup.
+		std::atomic<std::size_t> size_ = 0;
 	};
 
 	OsFile(std::shared_ptr<Context> context, std::filesystem::path p)
@@ -32,10 +173,11 @@ class OsFile: virtual public File {
 	OsFile(OsFile&& other)      = default;
 
 	[[nodiscard]] std::filesystem::perms perms() const override {
-		return std::filesystem::status(this->path_).permissions();
+		return this->stat().perms;
 	}
 
 	void perms(std::filesystem::perms perms, std::filesystem::perm_options opts) override {
+		OsStatCache::Invalidation const invalidation(this->stat_.get());
 		std::filesystem::permissions(this->path_, perms, opts);
 	}
 
@@ -49,18 +191,33 @@ class OsFile: virtual public File {
 	}
 
 	[[nodiscard]] std::filesystem::file_time_type last_write_time() const override {
-		return std::filesystem::last_write_time(this->path_);
+		return this->existing_stat_().last_write_time;
 	}
 
 	void last_write_time(std::filesystem::file_time_type new_time) override {
+		OsStatCache::Invalidation const invalidation(this->stat_.get());
 		std::filesystem::last_write_time(this->path_, new_time);
 	}
 
+	[[nodiscard]] OsStat stat() const {
+		return this->stat_->get(this->path_);
+	}
+
+	// Drops the cached attributes so the next query reads them from the OS.
+	void refresh() const noexcept {
+		this->stat_->clear();
+	}
+
+	// Caches `stat` already read by the caller.
+	void seed(OsStat const& stat) const {
+		this->stat_->set(stat);
+	}
+
 	[[nodiscard]] std::filesystem::path const& path() const {
 		return this->path_;
 	}
 
-	void move_to(std::filesystem::path const& p) {
+	virtual void move_to(std::filesystem::path const& p) {
 		std::filesystem::rename(this->path_, p);
 		this->path_ = p;
 	}
@@ -70,8 +227,14 @@ class OsFile: virtual public File {
 	}
 
    protected:
+	// Throws if the file does not exist.
+	[[nodiscard]] OsStat existing_stat_() const;
+
 	std::shared_ptr<Context> context_;
 	std::filesystem::path    path_;
+
+	// Shared by copies since they are the same file.
+	std::shared_ptr<OsStatCache> stat_ = std::make_shared<OsStatCache>();
 };
 
 class UnkownOsFile: public OsFile {
@@ -80,7 +243,7 @@ class UnkownOsFile: public OsFile {
 	    : OsFile(std::move(p)) { }
 
 	[[nodiscard]] std::filesystem::file_type type() const override {
-		return std::filesystem::status(this->path_).type();
+		return this->stat().type;
 	}
 };
 
@@ -94,11 +257,19 @@ class OsRegularFile
 	OsRegularFile(std::filesystem::path p)
 	    : OsFile(std::move(p)) { }
 
+	// Copies in the kernel if `other` is `OsRegularFile`.
+	void copy_from(RegularFile const& other) override;
+
 	[[nodiscard]] std::uintmax_t size() const override {
-		return std::filesystem::file_size(this->path_);
+		auto const s = this->existing_stat_();
+		if(s.type == std::filesystem::file_type::directory) {
+			throw std::filesystem::filesystem_error("", this->path_, std::make_error_code(std::errc::is_a_directory));
+		}
+		return s.size;
 	}
 
 	void resize(std::uintmax_t new_size) override {
+		OsStatCache::Invalidation const invalidation(this->stat_.get());
 		std::filesystem::resize_file(this->path_, new_size);
 	}
 
@@ -107,7 +278,34 @@ class OsRegularFile
 	}
 
 	std::shared_ptr<std::ostream> open_write(std::ios_base::openmode mode) override {
-		return std::make_shared<std::ofstream>(this->path_, mode | std::ios_base::out);
+		// Written contents are seen after the stream is closed, so the cache is also cleared then.
+		this->stat_->clear();
+		return std::shared_ptr<std::ostream>(new std::ofstream(this->path_, mode | std::ios_base::out), [stat = this->stat_](std::ostream* os) {
+			delete os;  // NOLINT(cppcoreguidelines-owning-memory)
+			stat->clear();
+		});
+	}
+
+	[[nodiscard]] std::shared_ptr<std::istream> map_read() const override {
+		return map_os_read(this->path_);
+	}
+
+	[[nodiscard]] std::string read_all() const override {
+		return read_os_file(this->path_);
+	}
+
+	[[nodiscard]] std::size_t read_at(std::uintmax_t offset, std::span<char> buf) const override {
+		return read_os_file_at(this->path_, offset, buf);
+	}
+
+	void write_all(std::string_view data, std::ios_base::openmode mode) override {
+		OsStatCache::Invalidation const invalidation(this->stat_.get());
+		write_os_file(this->path_, data, mode);
+	}
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_handle(std::ios_base::openmode mode) override {
+		OsStatCache::Invalidation const invalidation(this->stat_.get());
+		return open_os_file(this->path_, mode, this->stat_);
 	}
 };
 
@@ -126,15 +324,18 @@ class OsSymlink
 	}
 };
 
+// Entries are accessed by `*at` system calls relative to a descriptor of the directory,
+// so the kernel does not resolve the whole path on each access.
+// The descriptor is opened on the first access, relative to the parent's if the directory is made by its parent.
 class OsDirectory
     : public OsFile
     , public Directory {
    public:
-	OsDirectory(std::shared_ptr<Context> context, std::filesystem::path p)
-	    : OsFile(std::move(context), std::move(p)) { }
+	OsDirectory(std::shared_ptr<Context> context, std::filesystem::path p);
 
-	OsDirectory(std::filesystem::path p)
-	    : OsFile(std::move(p)) { }
+	OsDirectory(std::filesystem::path p);
+
+	void move_to(std::filesystem::path const& p) override;
 
 	[[nodiscard]] bool exists(std::filesystem::path const& p) const;
 
@@ -142,9 +343,7 @@ class OsDirectory
 		return std::filesystem::is_empty(this->path_);
 	}
 
-	[[nodiscard]] bool contains(std::string const& name) const override {
-		return this->exists(this->path_ / name);
-	}
+	[[nodiscard]] bool contains(std::string const& name) const override;
 
 	[[nodiscard]] std::shared_ptr<File> next(std::string const& name) const override;
 
@@ -169,8 +368,33 @@ class OsDirectory
 	std::uintmax_t clear() override;
 
 	[[nodiscard]] std::shared_ptr<Cursor> cursor() const override;
+
+	void watch_changes(ChangeWatch& watch) const override {
+		watch.add(std::shared_ptr<ChangeCounter const>(this->context_, &this->context_->changes));
+	}
+
+   protected:
+	class DirFd_;
+
+	class Cursor_;
+
+	[[nodiscard]] int dir_fd_() const;
+
+	// Calls `f` with the descriptor of the directory, and once more if it fails with `ENOENT`
+	// and the directory was replaced at its path since the descriptor was opened.
+	// `f` returns a negative value on failure with `errno` set, as the `*at` system calls do.
+	template<typename F>
+	int at_(F&& f) const;
+
+	// Makes the file of the entry `name` whose type is `type`.
+	[[nodiscard]] std::shared_ptr<File> make_child_(std::filesystem::file_type type, std::string const& name) const;
+
+	// Shared by copies since they are the same directory.
+	std::shared_ptr<DirFd_> fd_;
 };
 
+// Named file in the temporary directory, which holds no descriptor while it lives.
+// It is made by `O_TMPFILE` and linked if available, so its name is taken by one `linkat`.
 class TempRegularFile: public OsRegularFile {
    public:
 	TempRegularFile();
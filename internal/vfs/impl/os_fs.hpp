@@ -1,14 +1,21 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
 #include <system_error>
 #include <type_traits>
 #include <utility>
 
+#include "vfs/impl/fd.hpp"
 #include "vfs/impl/file.hpp"
 #include "vfs/impl/fs.hpp"
 #include "vfs/impl/fs_proxy.hpp"
@@ -87,10 +94,34 @@ class StdFs: public OsFs {
 		return std::make_shared<std::ifstream>(this->os_path_of(filename), mode);
 	}
 
+	[[nodiscard]] std::shared_ptr<std::istream> map_read(std::filesystem::path const& filename) const override {
+		return map_os_read(this->os_path_of(filename));
+	}
+
 	std::shared_ptr<std::ostream> open_write(std::filesystem::path const& filename, std::ios_base::openmode mode = std::ios_base::out) override {
 		return std::make_shared<std::ofstream>(this->os_path_of(filename), mode);
 	}
 
+	[[nodiscard]] std::string read_file(std::filesystem::path const& filename) const override {
+		return read_os_file(this->os_path_of(filename));
+	}
+
+	[[nodiscard]] std::size_t read_at(std::filesystem::path const& filename, std::uintmax_t offset, std::span<char> buf) const override {
+		return read_os_file_at(this->os_path_of(filename), offset, buf);
+	}
+
+	void write_file(std::filesystem::path const& filename, std::string_view data, std::ios_base::openmode mode) override {
+		write_os_file(this->os_path_of(filename), data, mode);
+	}
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_file(std::filesystem::path const& filename) const override {
+		return open_os_file(this->os_path_of(filename), std::ios_base::in);
+	}
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_file(std::filesystem::path const& filename, std::ios_base::openmode mode) override {
+		return open_os_file(this->os_path_of(filename), mode);
+	}
+
 	[[nodiscard]] std::shared_ptr<Fs const> change_root(std::filesystem::path const& p, std::filesystem::path const& temp_dir) const override;
 
 	[[nodiscard]] std::shared_ptr<Fs> change_root(std::filesystem::path const& p, std::filesystem::path const& temp_dir) override {
@@ -297,6 +328,19 @@ class StdFs: public OsFs {
 		return std::filesystem::symlink_status(this->os_path_of(p), ec);
 	}
 
+	// Each path costs one `statx`; large batches are split with the pool of the I/O engine.
+	[[nodiscard]] FileStatuses status_many(std::span<std::filesystem::path const> ps) const override;
+
+	// Run on `IoEngine`, which makes the reads, writes, and status queries through io_uring where the kernel provides one.
+	// A copy completes on the calling thread if this is not owned by a `std::shared_ptr`.
+	void async_read_file(std::filesystem::path const& filename, std::function<void(std::error_code, std::string)> callback) const override;
+
+	void async_write_file(std::filesystem::path const& filename, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) override;
+
+	void async_status(std::filesystem::path const& p, std::function<void(std::error_code, std::filesystem::file_status)> callback) const override;
+
+	void async_copy(std::filesystem::path const& src, std::filesystem::path const& dst, std::filesystem::copy_options opts, std::function<void(std::error_code)> callback) override;
+
 	[[nodiscard]] std::filesystem::path temp_directory_path() const override {
 		return std::filesystem::temp_directory_path();
 	}
@@ -346,6 +390,7 @@ class ChRootedStdFs: public StdFs {
 	    std::filesystem::path const& temp_dir)
 	    : StdFs(cwd)
 	    , base_(std::filesystem::canonical(base))
+	    , base_fd_(open_base_(this->base_))
 	    , temp_dir_(("/" / temp_dir).lexically_normal()) { }
 
 	[[nodiscard]] std::filesystem::path base_path() const override {
@@ -380,9 +425,16 @@ class ChRootedStdFs: public StdFs {
 		return this->temp_dir_;
 	}
 
+	// Paths that stay under the base are told by the kernel resolving them beneath the base,
+	// and canonicalized to clamp to the base otherwise.
 	[[nodiscard]] std::filesystem::path os_path_of(std::filesystem::path const& p) const override;
 
    protected:
+	// Holds no descriptor if the base cannot be opened, so every path is canonicalized.
+	[[nodiscard]] static Fd open_base_(std::filesystem::path const& base);
+
+	[[nodiscard]] bool is_beneath_(std::filesystem::path const& r) const;
+
 	[[nodiscard]] std::filesystem::path confine_(std::filesystem::path const& normal) const {
 		if(normal.is_relative()) {
 			return normal;
@@ -392,6 +444,7 @@ class ChRootedStdFs: public StdFs {
 	}
 
 	std::filesystem::path base_;
+	Fd                    base_fd_;
 	std::filesystem::path temp_dir_;
 };
 
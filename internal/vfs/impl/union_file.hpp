@@ -2,7 +2,9 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -10,6 +12,8 @@
 #include "vfs/impl/file.hpp"
 #include "vfs/impl/file_proxy.hpp"
 #include "vfs/impl/fs.hpp"
+#include "vfs/impl/lookup_cache.hpp"
+#include "vfs/impl/name.hpp"
 #include "vfs/impl/vfile.hpp"
 
 namespace vfs {
@@ -17,13 +21,26 @@ namespace impl {
 
 class UnionDirectory: public TypedFileProxy<Directory> {
    public:
-	struct Context {
+	// Guarded by its own lock since it is shared by the branches made on each lookup.
+	class Context {
+	   public:
 		// Always return a value; create new one if one does not exist.
 		[[nodiscard]] std::shared_ptr<Context> at(std::string const& name);
 
-		std::unordered_map<std::string, std::shared_ptr<Context>> child_context;
+		[[nodiscard]] bool is_hidden(std::string const& name) const;
 
-		std::unordered_set<std::string> hidden;
+		// Returns false if `name` is already hidden.
+		bool hide(std::string const& name);
+
+		// Notified on hiding and on files made through a lower-only branch.
+		ChangeCounter changes;
+
+	   private:
+		mutable std::shared_mutex mutex_;
+
+		std::unordered_map<std::string, std::shared_ptr<Context>> child_context_;
+
+		std::unordered_set<Name, Name::Hash, std::equal_to<>> hidden_;
 	};
 
 	UnionDirectory(std::shared_ptr<Context> context, std::shared_ptr<Directory> upper, std::shared_ptr<Directory const> lower);
@@ -58,6 +75,8 @@ class UnionDirectory: public TypedFileProxy<Directory> {
 
 	[[nodiscard]] std::shared_ptr<Cursor> cursor() const override;
 
+	void watch_changes(ChangeWatch& watch) const override;
+
    private:
 	[[nodiscard]] std::shared_ptr<File> lower_next_(std::string const& name) const;
 
@@ -3,6 +3,9 @@
 #include <concepts>
 #include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
 #include <string_view>
 #include <system_error>
 
@@ -29,6 +32,70 @@ auto handle_error(F const& f, std::error_code& ec, R v = R{}) noexcept -> R {
 
 [[nodiscard]] std::string to_string(std::filesystem::file_type t);
 
+// Reader/writer lock that does nothing if disabled, so that single-threaded users pay a pointer only.
+// Meets the requirements of SharedMutex, so use it with `std::shared_lock`, `std::unique_lock`, or `std::scoped_lock`.
+// A copy is a new lock in the same mode.
+class OptionalSharedMutex {
+   public:
+	OptionalSharedMutex() = default;
+
+	explicit OptionalSharedMutex(bool enabled)
+	    : mutex_(enabled ? std::make_unique<std::shared_mutex>() : nullptr) { }
+
+	OptionalSharedMutex(OptionalSharedMutex const& other)
+	    : OptionalSharedMutex(other.enabled()) { }
+
+	OptionalSharedMutex(OptionalSharedMutex&& other) noexcept = default;
+
+	OptionalSharedMutex& operator=(OptionalSharedMutex const& other) {
+		if(this->enabled() != other.enabled()) {
+			*this = OptionalSharedMutex(other.enabled());
+		}
+		return *this;
+	}
+
+	OptionalSharedMutex& operator=(OptionalSharedMutex&& other) noexcept = default;
+
+	[[nodiscard]] bool enabled() const noexcept {
+		return this->mutex_ != nullptr;
+	}
+
+	void lock() {
+		if(this->mutex_) {
+			this->mutex_->lock();
+		}
+	}
+
+	bool try_lock() {
+		return !this->mutex_ || this->mutex_->try_lock();
+	}
+
+	void unlock() {
+		if(this->mutex_) {
+			this->mutex_->unlock();
+		}
+	}
+
+	void lock_shared() {
+		if(this->mutex_) {
+			this->mutex_->lock_shared();
+		}
+	}
+
+	bool try_lock_shared() {
+		return !this->mutex_ || this->mutex_->try_lock_shared();
+	}
+
+	void unlock_shared() {
+		if(this->mutex_) {
+			this->mutex_->unlock_shared();
+		}
+	}
+
+   private:
+	std::unique_ptr<std::shared_mutex> mutex_;
+};
+
 // Use to avoid LWG 3657.
 struct PathHash {
 	std::size_t operator()(std::filesystem::path const& path) const {
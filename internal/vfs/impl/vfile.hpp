@@ -1,15 +1,26 @@
 #pragma once
 
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 
 #include "vfs/impl/file.hpp"
+#include "vfs/impl/flat_map.hpp"
+#include "vfs/impl/lookup_cache.hpp"
+#include "vfs/impl/name.hpp"
 #include "vfs/impl/os_file.hpp"
+#include "vfs/impl/utils.hpp"
 
 namespace vfs {
 namespace impl {
@@ -48,34 +59,93 @@ class VFile: virtual public File {
 	std::filesystem::file_time_type last_write_time_;
 };
 
+// Regular file that is kept in memory until it grows to `spill_size`, and then moved to a temporary file on the OS.
+// The file is moved only while no stream or handle is writing it;
+// one that grew while written is moved on the next write after the last writer closes, since writers close in destructors.
+// If the temporary file cannot be made, e.g. the disk is full, the file stays in memory.
 class VRegularFile
     : public VFile
-    , public TempRegularFile {
+    , public RegularFile
+    , public std::enable_shared_from_this<VRegularFile> {
    public:
-	VRegularFile(std::filesystem::perms perms = DefaultPerms);
+	static constexpr std::uintmax_t DefaultSpillSize = 4 * 1024 * 1024;
+
+	VRegularFile(std::filesystem::perms perms = DefaultPerms, std::uintmax_t spill_size = DefaultSpillSize);
 
 	VRegularFile(VRegularFile const& other) = delete;
-	VRegularFile(VRegularFile&& other)      = default;
+	VRegularFile(VRegularFile&& other)      = delete;
 
-	[[nodiscard]] std::filesystem::perms perms() const override {
-		return VFile::perms();
+	[[nodiscard]] std::filesystem::file_time_type last_write_time() const override {
+		return this->current_()->last_write_time();
 	}
 
-	void perms(std::filesystem::perms perms, std::filesystem::perm_options opts) override {
-		VFile::perms(perms, opts);
+	void last_write_time(std::filesystem::file_time_type new_time) override {
+		this->current_()->last_write_time(new_time);
 	}
 
-	bool operator==(File const& other) const override {
-		return VFile::operator==(other);
+	void copy_from(RegularFile const& other) override;
+
+	[[nodiscard]] std::uintmax_t size() const override {
+		return this->current_()->size();
 	}
 
-	[[nodiscard]] std::filesystem::file_time_type last_write_time() const override {
-		return TempRegularFile::last_write_time();
+	void resize(std::uintmax_t new_size) override;
+
+	[[nodiscard]] std::shared_ptr<std::istream> open_read(std::ios_base::openmode mode) const override {
+		return this->current_()->open_read(mode);
 	}
 
-	void last_write_time(std::filesystem::file_time_type new_time) override {
-		TempRegularFile::last_write_time(new_time);
+	std::shared_ptr<std::ostream> open_write(std::ios_base::openmode mode) override;
+
+	[[nodiscard]] std::shared_ptr<std::istream> map_read() const override {
+		return this->current_()->map_read();
+	}
+
+	[[nodiscard]] std::string read_all() const override {
+		return this->current_()->read_all();
+	}
+
+	[[nodiscard]] std::size_t read_at(std::uintmax_t offset, std::span<char> buf) const override {
+		return this->current_()->read_at(offset, buf);
 	}
+
+	void write_all(std::string_view data, std::ios_base::openmode mode) override;
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_handle(std::ios_base::openmode mode) override;
+
+	[[nodiscard]] bool in_memory() const {
+		std::lock_guard const lock(this->mutex_);
+		return this->in_memory_;
+	}
+
+	VRegularFile& operator=(VRegularFile const& other) = delete;
+	VRegularFile& operator=(VRegularFile&& other)      = delete;
+
+   private:
+	class Writing_;
+	class Handle_;
+
+	[[nodiscard]] std::shared_ptr<RegularFile> current_() const {
+		std::lock_guard const lock(this->mutex_);
+		return this->storage_;
+	}
+
+	// Moves the file to the OS first if it will be `size` bytes,
+	// where existing contents are kept only if `keep` is set.
+	std::shared_ptr<RegularFile> begin_write_(std::uintmax_t size, bool keep);
+
+	void end_write_() noexcept;
+
+	void spill_(bool keep);
+
+	mutable std::mutex mutex_;
+
+	// `MemRegularFile` if `in_memory_`, `TempRegularFile` otherwise.
+	std::shared_ptr<RegularFile> storage_;
+
+	std::uintmax_t spill_size_;
+	std::size_t    writers_   = 0;
+	bool           in_memory_ = true;
 };
 
 class VSymlink
@@ -94,21 +164,37 @@ class VSymlink
 	std::filesystem::path target_;
 };
 
-class VDirectory
+// Entries are hashed; `VDirectory`.
+using HashedFiles = std::unordered_map<Name, std::shared_ptr<File>, Name::Hash, std::equal_to<>>;
+
+// Entries are sorted by name in a contiguous array; `SortedVDirectory`.
+using SortedFiles = FlatMap<std::shared_ptr<File>>;
+
+// Directory made by `emplace_directory` is the same kind of directory.
+// If `concurrent`, each directory has its own reader/writer lock so that the tree can be used by multiple threads.
+template<typename Files>
+class BasicVDirectory
     : public VFile
     , public Directory {
    public:
-	VDirectory(std::filesystem::perms perms = DefaultPerms)
-	    : VFile(perms) { }
+	BasicVDirectory(std::filesystem::perms perms = DefaultPerms, bool concurrent = false)
+	    : VFile(perms)
+	    , mutex_(concurrent) { }
 
-	VDirectory(VDirectory const& other) = default;
-	VDirectory(VDirectory&& other)      = default;
+	BasicVDirectory(BasicVDirectory const& other) = default;
+	BasicVDirectory(BasicVDirectory&& other)      = default;
+
+	[[nodiscard]] bool concurrent() const noexcept {
+		return this->mutex_.enabled();
+	}
 
 	[[nodiscard]] bool empty() const override {
+		std::shared_lock const lock(this->mutex_);
 		return this->files_.empty();
 	}
 
 	[[nodiscard]] bool contains(std::string const& name) const override {
+		std::shared_lock const lock(this->mutex_);
 		return this->files_.contains(name);
 	}
 
@@ -122,9 +208,7 @@ class VDirectory
 
 	bool link(std::string const& name, std::shared_ptr<File> file) override;
 
-	bool unlink(std::string const& name) override {
-		return !this->files_.extract(name).empty();
-	}
+	bool unlink(std::string const& name) override;
 
 	void mount(std::string const& name, std::shared_ptr<File> file) override;
 
@@ -134,11 +218,42 @@ class VDirectory
 
 	std::uintmax_t clear() override;
 
+	bool move(std::string const& name, Directory& dst, std::string const& dst_name) override;
+
 	[[nodiscard]] std::shared_ptr<Cursor> cursor() const override;
 
+	void watch_changes(ChangeWatch& watch) const override {
+		watch.add(this->changes_);
+	}
+
    protected:
-	std::unordered_map<std::string, std::shared_ptr<File>> files_;
+	// Emplaces a file made by `make` only if `name` does not exist.
+	template<std::invocable<> Make>
+	std::pair<std::shared_ptr<File>, bool> emplace_(std::string const& name, Make const& make) {
+		std::unique_lock const lock(this->mutex_);
+		if(auto const it = this->files_.find(name); it != this->files_.end()) {
+			return std::make_pair(it->second, false);
+		}
+
+		auto const [it, _] = this->files_.emplace(Name(name), make());
+		this->changes_->notify_inserted();
+
+		return std::make_pair(it->second, true);
+	}
+
+	Files files_;
+
+	// Shared by copies.
+	std::shared_ptr<ChangeCounter> changes_ = std::make_shared<ChangeCounter>();
+
+	mutable OptionalSharedMutex mutex_;
 };
 
+extern template class BasicVDirectory<HashedFiles>;
+extern template class BasicVDirectory<SortedFiles>;
+
+using VDirectory       = BasicVDirectory<HashedFiles>;
+using SortedVDirectory = BasicVDirectory<SortedFiles>;
+
 }  // namespace impl
 }  // namespace vfs
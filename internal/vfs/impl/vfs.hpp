@@ -1,15 +1,21 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <iosfwd>
 #include <memory>
+#include <span>
 #include <stack>
+#include <string>
+#include <string_view>
 #include <system_error>
 
 #include "vfs/impl/entry.hpp"
 #include "vfs/impl/file.hpp"
 #include "vfs/impl/fs.hpp"
+#include "vfs/impl/lookup_cache.hpp"
 
 #include "vfs/directory_entry.hpp"
 #include "vfs/fs.hpp"
@@ -36,6 +42,18 @@ class Vfs: public FsBase {
 	[[nodiscard]] std::shared_ptr<std::istream> open_read(std::filesystem::path const& filename, std::ios_base::openmode mode = std::ios_base::in) const override;
 	std::shared_ptr<std::ostream>               open_write(std::filesystem::path const& filename, std::ios_base::openmode mode = std::ios_base::out) override;
 
+	[[nodiscard]] std::string read_file(std::filesystem::path const& filename) const override;
+
+	[[nodiscard]] std::size_t read_at(std::filesystem::path const& filename, std::uintmax_t offset, std::span<char> buf) const override;
+
+	[[nodiscard]] std::shared_ptr<std::istream> map_read(std::filesystem::path const& filename) const override;
+
+	void write_file(std::filesystem::path const& filename, std::string_view data, std::ios_base::openmode mode) override;
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_file(std::filesystem::path const& filename) const override;
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_file(std::filesystem::path const& filename, std::ios_base::openmode mode) override;
+
 	[[nodiscard]] std::shared_ptr<Fs const> change_root(std::filesystem::path const& p, std::filesystem::path const& temp_dir) const override;
 
 	[[nodiscard]] std::shared_ptr<Fs> change_root(std::filesystem::path const& p, std::filesystem::path const& temp_dir) override {
@@ -49,6 +67,9 @@ class Vfs: public FsBase {
 		return this->cwd_;
 	}
 
+	// `Fs`s derived from this one by `current_path` or `change_root` inherit the options.
+	void apply(VfsOptions const& opts);
+
 	[[nodiscard]] std::filesystem::path canonical(std::filesystem::path const& p) const override;
 
 	[[nodiscard]] std::filesystem::path weakly_canonical(std::filesystem::path const& p) const override;
@@ -103,12 +124,26 @@ class Vfs: public FsBase {
 
 	[[nodiscard]] std::filesystem::file_status symlink_status(std::filesystem::path const& p) const override;
 
+	// Consecutive paths in the same directory resolve the directory once.
+	[[nodiscard]] FileStatuses status_many(std::span<std::filesystem::path const> ps) const override;
+
+	// Files on the OS are read, written, and queried through `IoEngine` once their paths are resolved on the calling thread.
+	// Other files complete on the calling thread since their directories may not be shared with other threads.
+	void async_read_file(std::filesystem::path const& filename, std::function<void(std::error_code, std::string)> callback) const override;
+
+	void async_write_file(std::filesystem::path const& filename, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) override;
+
+	void async_status(std::filesystem::path const& p, std::function<void(std::error_code, std::filesystem::file_status)> callback) const override;
+
+	// Runs on `IoEngine` only if the OS can copy the whole subtree on its own.
+	void async_copy(std::filesystem::path const& src, std::filesystem::path const& dst, std::filesystem::copy_options opts, std::function<void(std::error_code)> callback) override;
+
 	[[nodiscard]] std::filesystem::path temp_directory_path() const override;
 
 	[[nodiscard]] bool is_empty(std::filesystem::path const& p) const override;
 
 	[[nodiscard]] std::shared_ptr<File const> file_at(std::filesystem::path const& p) const override {
-		return this->navigate(p)->file();
+		return this->lookup_(p, false);
 	}
 
 	[[nodiscard]] std::shared_ptr<File> file_at(std::filesystem::path const& p) override {
@@ -116,7 +151,7 @@ class Vfs: public FsBase {
 	}
 
 	[[nodiscard]] std::shared_ptr<File const> file_at_followed(std::filesystem::path const& p) const override {
-		return this->navigate(p)->follow_chain()->file();
+		return this->lookup_(p, true);
 	}
 
 	[[nodiscard]] std::shared_ptr<File> file_at_followed(std::filesystem::path const& p) override {
@@ -131,6 +166,19 @@ class Vfs: public FsBase {
 		return std::const_pointer_cast<Directory>(static_cast<Vfs const*>(this)->cwd());
 	}
 
+	// Resolves the path without materializing `Entry`s; use it if only the file is needed.
+	[[nodiscard]] Trail trail(std::filesystem::path const& p) const {
+		auto t = Trail(this->from_of_(p));
+		t.walk(p);
+		return t;
+	}
+
+	[[nodiscard]] Trail trail_followed(std::filesystem::path const& p) const {
+		auto t = this->trail(p);
+		t.follow_chain();
+		return t;
+	}
+
 	[[nodiscard]] std::pair<std::shared_ptr<Entry const>, std::filesystem::path::const_iterator> navigate(
 	    std::filesystem::path::const_iterator first,
 	    std::filesystem::path::const_iterator last,
@@ -195,9 +243,28 @@ class Vfs: public FsBase {
 	[[nodiscard]] std::shared_ptr<Fs::RecursiveCursor> recursive_cursor_(std::filesystem::path const& p, std::filesystem::directory_options opts) const override;
 
    private:
+	// Uses the cache if enabled.
+	[[nodiscard]] std::shared_ptr<File> lookup_(std::filesystem::path const& p, bool followed) const;
+
+	[[nodiscard]] std::shared_ptr<File> lookup_(std::filesystem::path const& p, bool followed, std::error_code& ec) const;
+
+	// Walks the tree and records the result to the cache if enabled.
+	[[nodiscard]] std::shared_ptr<File> resolve_(std::filesystem::path const& p, bool followed) const;
+
+	[[nodiscard]] std::shared_ptr<RegularFile const> regular_file_for_read_(std::filesystem::path const& filename) const;
+
+	// Creates the file if it does not exist; returns nullptr on failure.
+	[[nodiscard]] std::shared_ptr<RegularFile> regular_file_for_write_(std::filesystem::path const& filename, std::error_code& ec);
+
 	std::shared_ptr<DirectoryEntry> root_;
 	std::shared_ptr<DirectoryEntry> cwd_;
 	std::filesystem::path           temp_;
+
+	VfsOptions opts_;
+
+	// Remembers resolved paths if `opts_.cache_lookups`; see `LookupCache`.
+	// Keys are paths as given, which is fine since `cwd_` never changes.
+	std::shared_ptr<LookupCache> cache_;
 };
 
 }  // namespace impl
@@ -2,14 +2,26 @@
 #include "vfs/impl/os_fs.hpp"
 #include "vfs/impl/vfs.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <exception>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "vfs/impl/entry.hpp"
+#include "vfs/impl/file_proxy.hpp"
 #include "vfs/impl/fs_proxy.hpp"
+#include "vfs/impl/io_engine.hpp"
+#include "vfs/impl/os_file.hpp"
 #include "vfs/impl/utils.hpp"
 
 namespace fs = std::filesystem;
@@ -28,7 +40,73 @@ fs::filesystem_error err_create_hard_link_to_diff_fs_() {
 	return {"cannot create a hard link to different filesystem", std::make_error_code(std::errc::invalid_argument)};
 }
 
-bool emplace_regular_file_into(std::shared_ptr<RegularFile const> src_r, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts) {
+// Copies contents of regular files on at most `concurrency` threads.
+// Files are pushed while the directory skeleton is created, and copied by `run` after that.
+class CopyJobs_ {
+   public:
+	explicit CopyJobs_(std::size_t concurrency)
+	    : concurrency_(concurrency) { }
+
+	void push(std::shared_ptr<RegularFile> dst, std::shared_ptr<RegularFile const> src) {
+		this->jobs_.push_back(Job_{.dst = std::move(dst), .src = std::move(src)});
+	}
+
+	// Stops taking jobs on the first failure and rethrows the error of the earliest pushed job that failed.
+	void run();
+
+   private:
+	struct Job_ {
+		std::shared_ptr<RegularFile>       dst;
+		std::shared_ptr<RegularFile const> src;
+	};
+
+	std::size_t       concurrency_;
+	std::vector<Job_> jobs_;
+};
+
+void CopyJobs_::run() {
+	auto const jobs = std::exchange(this->jobs_, {});
+
+	std::vector<std::exception_ptr> errors(jobs.size());
+	std::atomic<std::size_t>        next   = 0;
+	std::atomic<bool>               failed = false;
+
+	auto const work = [&] {
+		while(!failed.load(std::memory_order_relaxed)) {
+			auto const i = next.fetch_add(1, std::memory_order_relaxed);
+			if(i >= jobs.size()) {
+				return;
+			}
+
+			try {
+				jobs[i].dst->copy_from(*jobs[i].src);
+			} catch(...) {
+				errors[i] = std::current_exception();
+				failed.store(true, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	{
+		auto const n = std::min(this->concurrency_, jobs.size());
+
+		std::vector<std::jthread> workers;
+		workers.reserve(n);
+		for(std::size_t i = 1; i < n; ++i) {
+			workers.emplace_back(work);
+		}
+
+		work();
+	}
+
+	for(auto const& error: errors) {
+		if(error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+bool emplace_regular_file_into(std::shared_ptr<RegularFile const> src_r, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts, CopyJobs_* jobs) {
 	auto const [dst_r, ok] = dst_prev.emplace_regular_file(dst_p.filename());
 	auto const commit      = [&dst_r = dst_r, &src_r = src_r]() -> bool {
         // NOLINTNEXTLINE
@@ -38,6 +116,13 @@ bool emplace_regular_file_into(std::shared_ptr<RegularFile const> src_r, fs::pat
 	};
 
 	if(ok) {
+		// Only new files are deferred; an existing one may be a hard link of another destination
+		// and a proxy may modify its directory on write.
+		if(jobs != nullptr && dynamic_cast<FileProxy const*>(dst_r.get()) == nullptr) {
+			jobs->push(dst_r, std::move(src_r));
+			return true;
+		}
+
 		return commit();
 	}
 
@@ -64,7 +149,7 @@ bool emplace_regular_file_into(std::shared_ptr<RegularFile const> src_r, fs::pat
 	throw fs::filesystem_error("", src_p, dst_p, std::make_error_code(std::errc::file_exists));
 }
 
-void copy_regular_file_into_(std::shared_ptr<RegularFile const> src, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts) {
+void copy_regular_file_into_(std::shared_ptr<RegularFile const> src, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts, CopyJobs_* jobs) {
 	if((opts & fs::copy_options::directories_only) == fs::copy_options::directories_only) {
 		return;
 	}
@@ -82,9 +167,9 @@ void copy_regular_file_into_(std::shared_ptr<RegularFile const> src, fs::path co
 
 	auto next_f = dst_prev.next(dst_p.filename());
 	if(auto next_d = std::dynamic_pointer_cast<Directory>(std::move(next_f)); next_d) {
-		emplace_regular_file_into(src, src_p, *next_d, dst_p / src_p.filename(), opts);
+		emplace_regular_file_into(src, src_p, *next_d, dst_p / src_p.filename(), opts, jobs);
 	} else {
-		emplace_regular_file_into(src, src_p, dst_prev, dst_p, opts);
+		emplace_regular_file_into(src, src_p, dst_prev, dst_p, opts, jobs);
 	}
 }
 
@@ -102,9 +187,9 @@ void copy_symlink_into_(std::shared_ptr<Symlink const> src, fs::path const& src_
 	}
 }
 
-void copy_into_(std::shared_ptr<File const> src, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts);
+void copy_into_(std::shared_ptr<File const> src, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts, CopyJobs_* jobs);
 
-void copy_directory_into_(std::shared_ptr<Directory const> src, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts) {
+void copy_directory_into_(std::shared_ptr<Directory const> src, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts, CopyJobs_* jobs) {
 	if((opts & fs::copy_options::create_symlinks) == fs::copy_options::create_symlinks) {
 		throw fs::filesystem_error("", src_p, std::make_error_code(std::errc::is_a_directory));
 	}
@@ -139,13 +224,82 @@ void copy_directory_into_(std::shared_ptr<Directory const> src, fs::path const&
 		}
 		};
 
-		copy_into_(cursor->file(), src_p / cursor->name(), *dst_d, dst_p / cursor->name(), opts);
+		copy_into_(cursor->file(), src_p / cursor->name(), *dst_d, dst_p / cursor->name(), opts, jobs);
+	}
+}
+
+// Copy of a whole subtree the OS can make on its own.
+struct OsCopy_ {
+	fs::path         src;
+	fs::path         dst;
+	fs::copy_options opts;
+
+	std::shared_ptr<OsFile::Context> dst_context;
+
+	// Notifies the destination tree even on failure since some files may have been copied.
+	void run(std::error_code& ec) const {
+		fs::copy(this->src, this->dst, this->opts, ec);
+		this->dst_context->changes.notify_inserted();
+	}
+};
+
+// Returns the copy for the OS to make if both sides are on the OS and no file in them is mounted.
+// `std::filesystem::copy` copies regular files in the kernel where possible.
+std::optional<OsCopy_> os_copy_of_(File const& src, Directory const& dst_prev, fs::path const& dst_p, fs::copy_options opts) {
+	auto const* src_os  = dynamic_cast<OsFile const*>(&src);
+	auto const* prev_os = dynamic_cast<OsDirectory const*>(&dst_prev);
+	if(src_os == nullptr || prev_os == nullptr) {
+		return std::nullopt;
+	}
+
+	auto dst_os_p = prev_os->path() / dst_p.filename();
+	if(src_os->context()->has_mount_point_within(src_os->path()) || prev_os->context()->has_mount_point_within(dst_os_p)) {
+		return std::nullopt;
+	}
+
+	// `std::filesystem::copy` follows symlinks in the directory unless told otherwise,
+	// where the generic copy skips them.
+	constexpr auto symlink_opts = fs::copy_options::copy_symlinks | fs::copy_options::skip_symlinks;
+	if(dynamic_cast<OsDirectory const*>(src_os) != nullptr && (opts & symlink_opts) == fs::copy_options::none) {
+		if(opts == fs::copy_options::none) {
+			// Any option makes `std::filesystem::copy` skip the directory that is copied without option.
+			return std::nullopt;
+		}
+
+		opts |= fs::copy_options::skip_symlinks;
+	}
+
+	return OsCopy_{
+	    .src         = src_os->path(),
+	    .dst         = std::move(dst_os_p),
+	    .opts        = opts,
+	    .dst_context = prev_os->context(),
+	};
+}
+
+bool copy_by_os_(File const& src, Directory const& dst_prev, fs::path const& dst_p, fs::copy_options opts) {
+	auto const c = os_copy_of_(src, dst_prev, dst_p, opts);
+	if(!c) {
+		return false;
 	}
+
+	std::error_code ec;
+	c->run(ec);
+	if(ec) {
+		throw fs::filesystem_error("", c->src, c->dst, ec);
+	}
+
+	return true;
 }
 
-void copy_into_(std::shared_ptr<File const> src, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts) {
+void copy_into_(std::shared_ptr<File const> src, fs::path const& src_p, Directory& dst_prev, fs::path const& dst_p, fs::copy_options opts, CopyJobs_* jobs) {
+	// `std::filesystem::copy` copies files one by one, so it is not used if the copy can be parallelized.
+	if(jobs == nullptr && copy_by_os_(*src, dst_prev, dst_p, opts)) {
+		return;
+	}
+
 	if(auto src_r = std::dynamic_pointer_cast<RegularFile const>(std::move(src)); src_r) {
-		copy_regular_file_into_(std::move(src_r), src_p, dst_prev, dst_p, opts);
+		copy_regular_file_into_(std::move(src_r), src_p, dst_prev, dst_p, opts, jobs);
 		return;
 	}
 
@@ -155,15 +309,16 @@ void copy_into_(std::shared_ptr<File const> src, fs::path const& src_p, Director
 	}
 
 	if(auto src_d = std::dynamic_pointer_cast<Directory const>(std::move(src)); src_d) {
-		copy_directory_into_(std::move(src_d), src_p, dst_prev, dst_p, opts);
+		copy_directory_into_(std::move(src_d), src_p, dst_prev, dst_p, opts, jobs);
 		return;
 	}
 
 	throw fs::filesystem_error("source is not a not a regular file, a directory, or a symlink", src_p, std::make_error_code(std::errc::invalid_argument));
 }
 
-void copy_into_(FsBase const& self, fs::path const& src, FsBase& other, fs::path const& dst, fs::copy_options opts) {
-	// No `std::filesystem::copy` even if both `src` and `dst` are `OsFile` since subpath may be a mounted VFile.
+void copy_into_(FsBase const& self, fs::path const& src, FsBase& other, fs::path const& dst, fs::copy_options opts, std::size_t concurrency = 1) {
+	// `std::filesystem::copy` is used only for subtrees that have no mounted file
+	// since a subpath may be a mounted VFile.
 
 	auto const src_p = self.canonical(src);
 	auto const src_f = self.file_at(src_p);
@@ -174,7 +329,21 @@ void copy_into_(FsBase const& self, fs::path const& src, FsBase& other, fs::path
 		throw fs::filesystem_error("", dst_p.parent_path(), std::make_error_code(std::errc::not_a_directory));
 	}
 
-	copy_into_(src_f, src_p, *dst_prev, dst_p, opts);
+	if(concurrency <= 1 || (opts & fs::copy_options::recursive) != fs::copy_options::recursive) {
+		copy_into_(src_f, src_p, *dst_prev, dst_p, opts, nullptr);
+		return;
+	}
+
+	CopyJobs_ jobs(concurrency);
+	try {
+		copy_into_(src_f, src_p, *dst_prev, dst_p, opts, &jobs);
+	} catch(...) {
+		// Files visited before the failure would have been copied by the serial copy.
+		jobs.run();
+		throw;
+	}
+
+	jobs.run();
 }
 
 }  // namespace
@@ -198,7 +367,33 @@ void StdFs::copy_(fs::path const& src, Fs& other, fs::path const& dst, fs::copy_
 }
 
 void Vfs::copy(fs::path const& src, fs::path const& dst, fs::copy_options opts) {
-	copy_into_(*this, src, *this, dst, opts);
+	copy_into_(*this, src, *this, dst, opts, this->opts_.copy_concurrency);
+}
+
+void Vfs::async_copy(fs::path const& src, fs::path const& dst, fs::copy_options opts, std::function<void(std::error_code)> callback) {
+	// Other copies walk the directories of this file system, which may not be shared with other threads.
+	std::optional<OsCopy_> c;
+	try {
+		auto const src_p = this->canonical(src);
+		auto const dst_p = this->weakly_canonical(dst);
+
+		auto const dst_prev = std::dynamic_pointer_cast<Directory const>(this->file_at(dst_p.parent_path()));
+		if(dst_prev) {
+			c = os_copy_of_(*this->file_at(src_p), *dst_prev, dst_p, opts);
+		}
+	} catch(fs::filesystem_error const&) {
+		// Reported by the copy below.
+	}
+	if(!c) {
+		this->FsBase::async_copy(src, dst, opts, std::move(callback));
+		return;
+	}
+
+	IoEngine::instance().submit([c = std::move(*c), callback = std::move(callback)] {
+		std::error_code ec;
+		c.run(ec);
+		callback(ec);
+	});
 }
 
 void Vfs::copy_(fs::path const& src, Fs& other, fs::path const& dst, fs::copy_options opts) const {
@@ -209,7 +404,7 @@ void Vfs::copy_(fs::path const& src, Fs& other, fs::path const& dst, fs::copy_op
 		throw err_create_hard_link_to_diff_fs_();
 	}
 
-	copy_into_(*this, src, fs_base(other), dst, opts);
+	copy_into_(*this, src, fs_base(other), dst, opts, this->opts_.copy_concurrency);
 }
 
 }  // namespace impl
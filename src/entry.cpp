@@ -1,12 +1,15 @@
 #include "vfs/impl/entry.hpp"
 
 #include <filesystem>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <system_error>
 #include <unordered_set>
 #include <utility>
 
 #include "vfs/impl/file.hpp"
+#include "vfs/impl/lookup_cache.hpp"
 #include "vfs/impl/vfile.hpp"
 
 namespace fs = std::filesystem;
@@ -34,7 +37,7 @@ std::shared_ptr<DirectoryEntry const> Entry::root() const {
 
 std::filesystem::path Entry::path() const {
 	if(this->prev_) {
-		return this->prev_->path() / this->name_;
+		return this->prev_->path() / this->name_.str();
 	}
 	return "/";
 }
@@ -51,85 +54,52 @@ std::shared_ptr<DirectoryEntry const> DirectoryEntry::prev() const {
 	return std::static_pointer_cast<DirectoryEntry const>(this->shared_from_this());
 }
 
-std::shared_ptr<Entry const> DirectoryEntry::next(std::string const& name) const {
-	auto f = this->typed_file()->next(name);
-	if(!f) {
-		throw fs::filesystem_error("", this->path(), name, std::make_error_code(std::errc::no_such_file_or_directory));
-	}
+namespace {
 
-	auto prev = const_cast<DirectoryEntry*>(this)->shared_from_this()->must_be<DirectoryEntry>();
+std::shared_ptr<Entry const> make_entry_(std::string name, std::shared_ptr<DirectoryEntry> prev, std::shared_ptr<File> f) {
 	using fs::file_type;
 	switch(f->type()) {
 	case file_type::regular:
-		return std::make_shared<RegularFileEntry>(name, std::move(prev), std::dynamic_pointer_cast<RegularFile>(std::move(f)));
+		return std::make_shared<RegularFileEntry>(std::move(name), std::move(prev), std::dynamic_pointer_cast<RegularFile>(std::move(f)));
 	case file_type::directory:
-		return std::make_shared<DirectoryEntry>(name, std::move(prev), std::dynamic_pointer_cast<Directory>(std::move(f)));
+		return std::make_shared<DirectoryEntry>(std::move(name), std::move(prev), std::dynamic_pointer_cast<Directory>(std::move(f)));
 	case file_type::symlink:
-		return std::make_shared<SymlinkEntry>(name, std::move(prev), std::dynamic_pointer_cast<Symlink>(std::move(f)));
+		return std::make_shared<SymlinkEntry>(std::move(name), std::move(prev), std::dynamic_pointer_cast<Symlink>(std::move(f)));
 
 	default:
-		return std::make_shared<UnknownTypeEntry>(name, std::move(prev), std::dynamic_pointer_cast<Symlink>(std::move(f)));
+		return std::make_shared<UnknownTypeEntry>(std::move(name), std::move(prev), std::move(f));
 	}
 }
 
-void navigate(
-    std::shared_ptr<Entry const>& entry,
-    fs::path::const_iterator&     first,
-    fs::path::const_iterator      last) {
-	do {
-		if(first == last) {
-			break;
-		}
-
-		if(!first->is_absolute()) {
-			break;
-		}
-
-		++first;
-		entry = entry->root();
-	} while(true);
+}  // namespace
 
-	for(; first != last; ++first) {
-		if(auto l = std::dynamic_pointer_cast<SymlinkEntry const>(entry); l) {
-			entry = l->follow_chain();
-		}
-
-		auto d = std::dynamic_pointer_cast<DirectoryEntry const>(entry);
-		if(!d) {
-			throw fs::filesystem_error("", entry->path(), std::make_error_code(std::errc::not_a_directory));
-		}
-
-		auto const& name = *first;
-		if(name == "." || name.empty()) {
-			continue;
-		}
-		if(name == "..") {
-			entry = entry->prev();
-			continue;
-		}
-
-		entry = d->next(name);
+std::shared_ptr<Entry const> DirectoryEntry::next(std::string const& name) const {
+	auto f = this->typed_file()->next(name);
+	if(!f) {
+		throw fs::filesystem_error("", this->path(), name, std::make_error_code(std::errc::no_such_file_or_directory));
 	}
+
+	auto prev = std::const_pointer_cast<DirectoryEntry>(std::static_pointer_cast<DirectoryEntry const>(this->shared_from_this()));
+	return make_entry_(name, std::move(prev), std::move(f));
 }
 
 std::pair<std::shared_ptr<Entry const>, fs::path::const_iterator> DirectoryEntry::navigate(fs::path::const_iterator first, fs::path::const_iterator last, std::error_code& ec) const {
-	auto rst = std::make_pair(this->shared_from_this(), first);
+	auto t = Trail(std::static_pointer_cast<DirectoryEntry const>(this->shared_from_this()));
 	try {
-		impl::navigate(rst.first, rst.second, last);
+		t.walk(first, last);
 		ec.clear();
 	} catch(fs::filesystem_error const& err) {
 		ec = err.code();
 	}
 
-	return rst;
+	return std::make_pair(t.entry(), first);
 }
 
 std::shared_ptr<Entry const> DirectoryEntry::navigate(std::filesystem::path const& p) const {
-	auto entry = this->shared_from_this();
-	auto it    = p.begin();
-	impl::navigate(entry, it, p.end());
+	auto t = Trail(std::static_pointer_cast<DirectoryEntry const>(this->shared_from_this()));
+	t.walk(p);
 
-	return entry;
+	return t.entry();
 }
 
 std::shared_ptr<RegularFile> DirectoryEntry::emplace_regular_file(std::string const& name) {
@@ -186,5 +156,116 @@ std::shared_ptr<Entry const> SymlinkEntry::follow_chain() const {
 	} while(true);
 }
 
+std::shared_ptr<File> Trail::file() const {
+	if(this->steps_.empty()) {
+		return std::const_pointer_cast<File>(this->anchor_->file());
+	}
+
+	return this->steps_.back().file;
+}
+
+fs::path Trail::path() const {
+	auto p = this->anchor_->path();
+	for(auto const& step: this->steps_) {
+		p /= step.name;
+	}
+
+	return p;
+}
+
+std::shared_ptr<Entry const> Trail::entry() const {
+	if(this->steps_.empty()) {
+		return this->anchor_;
+	}
+
+	// All the steps except the last one are directories.
+	auto prev = std::const_pointer_cast<DirectoryEntry>(this->anchor_);
+	auto last = std::prev(this->steps_.end());
+	for(auto it = this->steps_.begin(); it != last; ++it) {
+		prev = std::make_shared<DirectoryEntry>(it->name, std::move(prev), std::dynamic_pointer_cast<Directory>(it->file));
+	}
+
+	return make_entry_(last->name, std::move(prev), last->file);
+}
+
+void Trail::walk(fs::path::const_iterator& first, fs::path::const_iterator last) {
+	for(; first != last && first->is_absolute(); ++first) {
+		this->anchor_ = this->anchor_->root();
+		this->steps_.clear();
+	}
+
+	for(; first != last; ++first) {
+		if(this->last_()->type() == fs::file_type::symlink) {
+			this->follow_chain();
+		}
+
+		auto const* d = dynamic_cast<Directory const*>(this->last_());
+		if(d == nullptr) {
+			throw fs::filesystem_error("", this->path(), std::make_error_code(std::errc::not_a_directory));
+		}
+
+		auto const& name = first->native();
+		if(name == "." || name.empty()) {
+			continue;
+		}
+		if(name == "..") {
+			this->pop_();
+			continue;
+		}
+
+		if(this->watch_ != nullptr) {
+			d->watch_changes(*this->watch_);
+		}
+
+		auto f = d->next(name);
+		if(!f) {
+			throw fs::filesystem_error("", this->path(), name, std::make_error_code(std::errc::no_such_file_or_directory));
+		}
+
+		this->steps_.push_back(Step{.name = name, .file = std::move(f)});
+	}
+}
+
+void Trail::follow_chain() {
+	if(this->last_()->type() != fs::file_type::symlink) {
+		return;
+	}
+
+	// Anchor is always a directory so the symlink is on the steps.
+	auto t = *this;
+	do {
+		if(++t.hops_ > MaxSymlinkHops) {
+			throw fs::filesystem_error("circular symlinks", this->path(), std::make_error_code(std::errc::too_many_symbolic_link_levels));
+		}
+
+		auto const target = dynamic_cast<Symlink const&>(*t.steps_.back().file).target();
+		t.steps_.pop_back();
+
+		try {
+			t.walk(target);
+		} catch(fs::filesystem_error const& err) {
+			throw fs::filesystem_error(this->path().string() + " -> ", err.path1(), err.path2(), err.code());
+		}
+	} while(t.last_()->type() == fs::file_type::symlink);
+
+	*this = std::move(t);
+}
+
+File const* Trail::last_() const {
+	if(this->steps_.empty()) {
+		return this->anchor_->typed_file().get();
+	}
+
+	return this->steps_.back().file.get();
+}
+
+void Trail::pop_() {
+	if(this->steps_.empty()) {
+		this->anchor_ = this->anchor_->prev();
+	} else {
+		this->steps_.pop_back();
+	}
+}
+
 }  // namespace impl
 }  // namespace vfs
@@ -1,10 +1,18 @@
 #include "vfs/impl/file.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <iostream>
+#include <iterator>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -12,22 +20,65 @@ namespace vfs {
 namespace impl {
 
 void RegularFile::copy_from(RegularFile const& other) {
-	*this->open_write() << other.open_read()->rdbuf();
+	constexpr std::size_t BufferSize = 1 << 20;
+
+	auto const in  = other.open_read();
+	auto const out = this->open_write();
+
+	// Large reads and writes bypass the buffer of file streams.
+	auto const buffer = std::make_unique_for_overwrite<char[]>(BufferSize);
+	while(*in && *out) {
+		in->read(buffer.get(), BufferSize);
+		out->write(buffer.get(), in->gcount());
+	}
+
 	this->perms(other.perms(), fs::perm_options::replace);
 }
 
-Directory::StaticCursor::StaticCursor(std::unordered_map<std::string, std::shared_ptr<File>> const& files)
-    : files_(files)
-    , it_(this->files_.cbegin())
-    , end_(this->files_.cend()) { }
+std::string RegularFile::read_all() const {
+	auto const in = this->open_read();
+	if(!*in) {
+		throw fs::filesystem_error("", std::make_error_code(std::errc::io_error));
+	}
+
+	return std::string(std::istreambuf_iterator<char>(*in), std::istreambuf_iterator<char>());
+}
+
+std::size_t RegularFile::read_at(std::uintmax_t offset, std::span<char> buf) const {
+	auto const in = this->open_read();
+	if(!in->seekg(static_cast<std::streamoff>(offset))) {
+		// Beyond the end.
+		return 0;
+	}
+
+	in->read(buf.data(), static_cast<std::streamsize>(buf.size()));
+	return static_cast<std::size_t>(in->gcount());
+}
+
+void RegularFile::write_all(std::string_view data, std::ios_base::openmode mode) {
+	auto const out = this->open_write(mode);
+	out->write(data.data(), static_cast<std::streamsize>(data.size()));
+	out->flush();
+	if(!*out) {
+		throw fs::filesystem_error("", std::make_error_code(std::errc::io_error));
+	}
+}
+
+Directory::StaticCursor::StaticCursor(std::unordered_map<std::string, std::shared_ptr<File>> const& files) {
+	this->files_.reserve(files.size());
+	for(auto const& [name, f]: files) {
+		this->files_.emplace_back(Name(name), f);
+	}
+
+	this->it_ = this->files_.cbegin();
+}
 
-Directory::StaticCursor::StaticCursor(std::unordered_map<std::string, std::shared_ptr<File>>&& files)
+Directory::StaticCursor::StaticCursor(std::vector<std::pair<Name, std::shared_ptr<File>>> files)
     : files_(std::move(files))
-    , it_(this->files_.cbegin())
-    , end_(this->files_.cend()) { }
+    , it_(this->files_.cbegin()) { }
 
 std::string const& Directory::StaticCursor::name() const {
-	return this->it_->first;
+	return this->it_->first.str();
 }
 
 std::shared_ptr<File> const& Directory::StaticCursor::file() const {
@@ -43,7 +94,7 @@ void Directory::StaticCursor::increment() {
 }
 
 bool Directory::StaticCursor::at_end() const {
-	return this->it_ == this->end_;
+	return this->it_ == this->files_.cend();
 }
 
 Directory::Iterator::Iterator(std::shared_ptr<Cursor> cursor)
@@ -1,8 +1,16 @@
 #include "vfs/fs.hpp"
 #include "vfs/impl/fs.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <ios>
 #include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
 
 #include "vfs/directory_iterator.hpp"
 
@@ -17,6 +25,73 @@ directory_iterator& directory_iterator::increment(std::error_code& ec) {
 	return *this;
 }
 
+namespace impl {
+
+FileStatuses FsBase::status_many(std::span<fs::path const> ps) const {
+	FileStatuses rst;
+	rst.resize(ps.size());
+
+	for(std::size_t i = 0; i < ps.size(); ++i) {
+		auto const& p  = ps[i];
+		auto&       ec = rst.errors[i];
+
+		auto const s = this->status(p, ec);
+		if(ec == std::errc::no_such_file_or_directory || ec == std::errc::not_a_directory || s.type() == fs::file_type::not_found) {
+			ec.clear();
+			rst.types[i] = fs::file_type::not_found;
+			continue;
+		}
+		if(ec) {
+			continue;
+		}
+
+		auto const size = s.type() == fs::file_type::regular ? this->file_size(p, ec) : static_cast<std::uintmax_t>(-1);
+		if(ec) {
+			continue;
+		}
+
+		auto const t = this->last_write_time(p, ec);
+		if(ec) {
+			continue;
+		}
+
+		rst.types[i]            = s.type();
+		rst.perms[i]            = s.permissions();
+		rst.sizes[i]            = size;
+		rst.last_write_times[i] = t;
+	}
+
+	return rst;
+}
+
+void FsBase::async_read_file(fs::path const& filename, std::function<void(std::error_code, std::string)> callback) const {
+	std::error_code ec;
+
+	auto data = this->read_file(filename, ec);
+	callback(ec, std::move(data));
+}
+
+void FsBase::async_write_file(fs::path const& filename, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) {
+	std::error_code ec;
+	this->write_file(filename, data, mode, ec);
+	callback(ec);
+}
+
+void FsBase::async_status(fs::path const& p, std::function<void(std::error_code, fs::file_status)> callback) const {
+	std::error_code ec;
+
+	auto const s = this->status(p, ec);
+	callback(ec, s);
+}
+
+void FsBase::async_copy(fs::path const& src, fs::path const& dst, fs::copy_options opts, std::function<void(std::error_code)> callback) {
+	std::error_code ec;
+	this->copy(src, dst, opts, ec);
+	callback(ec);
+}
+
+}  // namespace impl
+
 recursive_directory_iterator& recursive_directory_iterator::increment(std::error_code& ec) {
 	impl::handle_error([&] { this->operator++(); return 0; }, ec);
 	return *this;
@@ -0,0 +1,591 @@
+#include "vfs/impl/io_engine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#include "vfs/impl/os_file.hpp"
+#include "vfs/impl/utils.hpp"
+
+namespace fs = std::filesystem;
+
+namespace vfs {
+namespace impl {
+
+// Operations take the results of the system calls they make, which are negated `errno` on failure.
+// Each callback is called on the thread that reaps the completions, so it must not block.
+#if defined(__linux__) && defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup) && defined(STATX_BASIC_STATS)
+
+// Queues shared with the kernel, set up by the system calls so that no library is needed.
+class IoEngine::Ring_ {
+   public:
+	// Returns null if the kernel has no io_uring, it is disabled, or it lacks the operations used here.
+	static std::unique_ptr<Ring_> make(unsigned entries) {
+		io_uring_params params{};
+
+		auto const fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+		if(fd < 0) {
+			return nullptr;
+		}
+
+		// `IORING_OP_OPENAT`, `IORING_OP_STATX`, and reads at the file position came with this feature.
+		if((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+			::close(fd);
+			return nullptr;
+		}
+
+		auto ring = std::unique_ptr<Ring_>(new Ring_(fd, params));
+		if(!ring->map_(params)) {
+			return nullptr;
+		}
+
+		ring->reaper_ = std::jthread([ring = ring.get()] { ring->reap_(); });
+		return ring;
+	}
+
+	Ring_(Ring_ const& other) = delete;
+	Ring_(Ring_&& other)      = delete;
+
+	~Ring_() {
+		if(this->reaper_.joinable()) {
+			// An entry without `Op_` tells the reaper to stop.
+			{
+				std::lock_guard const lock(this->mutex_);
+				this->submit_(nullptr);
+				this->enter_();
+			}
+
+			this->reaper_.join();
+		}
+
+		if(this->sqes_ != nullptr) {
+			::munmap(this->sqes_, this->sqes_size_);
+		}
+		if(this->cq_ptr_ != nullptr && this->cq_ptr_ != this->sq_ptr_) {
+			::munmap(this->cq_ptr_, this->cq_size_);
+		}
+		if(this->sq_ptr_ != nullptr) {
+			::munmap(this->sq_ptr_, this->sq_size_);
+		}
+
+		::close(this->fd_);
+	}
+
+	Ring_& operator=(Ring_ const& other) = delete;
+	Ring_& operator=(Ring_&& other)      = delete;
+
+	void open(fs::path p, int flags, std::function<void(int)> done) {
+		auto prepare = [p = std::move(p), flags](io_uring_sqe& sqe) {
+			sqe.opcode     = IORING_OP_OPENAT;
+			sqe.fd         = AT_FDCWD;
+			sqe.addr       = reinterpret_cast<std::uintptr_t>(p.c_str());
+			sqe.len        = 0666;
+			sqe.open_flags = flags | O_CLOEXEC;
+		};
+		this->push_(std::move(prepare), std::move(done));
+	}
+
+	// Reads at the file position, so that files without offsets, e.g. pipes, can be read too.
+	void read(int fd, std::span<char> buf, std::function<void(int)> done) {
+		auto prepare = [fd, buf](io_uring_sqe& sqe) {
+			sqe.opcode = IORING_OP_READ;
+			sqe.fd     = fd;
+			sqe.addr   = reinterpret_cast<std::uintptr_t>(buf.data());
+			sqe.len    = static_cast<std::uint32_t>(std::min<std::size_t>(buf.size(), MaxIoSize_));
+			sqe.off    = static_cast<std::uint64_t>(-1);
+		};
+		this->push_(std::move(prepare), std::move(done));
+	}
+
+	void write(int fd, std::span<char const> buf, std::function<void(int)> done) {
+		auto prepare = [fd, buf](io_uring_sqe& sqe) {
+			sqe.opcode = IORING_OP_WRITE;
+			sqe.fd     = fd;
+			sqe.addr   = reinterpret_cast<std::uintptr_t>(buf.data());
+			sqe.len    = static_cast<std::uint32_t>(std::min<std::size_t>(buf.size(), MaxIoSize_));
+			sqe.off    = static_cast<std::uint64_t>(-1);
+		};
+		this->push_(std::move(prepare), std::move(done));
+	}
+
+	// `done` takes the mode of the file, following a symbolic link.
+	void stat(fs::path p, std::function<void(int, unsigned)> done) {
+		auto stx     = std::make_shared<struct statx>();
+		auto prepare = [p = std::move(p), stx](io_uring_sqe& sqe) {
+			sqe.opcode      = IORING_OP_STATX;
+			sqe.fd          = AT_FDCWD;
+			sqe.addr        = reinterpret_cast<std::uintptr_t>(p.c_str());
+			sqe.len         = STATX_TYPE | STATX_MODE;
+			sqe.off         = reinterpret_cast<std::uintptr_t>(stx.get());
+			sqe.statx_flags = 0;
+		};
+		this->push_(std::move(prepare), [stx, done = std::move(done)](int res) { done(res, stx->stx_mode); });
+	}
+
+   private:
+	// Larger I/O is split as `read` and `write` do.
+	static constexpr std::size_t MaxIoSize_ = 0x7ffff000;
+
+	// Kept until the completion since the kernel may read the arguments, e.g. a path, any time before.
+	struct Op_ {
+		std::function<void(io_uring_sqe&)> prepare;
+		std::function<void(int)>           done;
+	};
+
+	Ring_(int fd, io_uring_params const& params)
+	    : fd_(fd)
+	    , sq_entries_(params.sq_entries)
+	    , cq_entries_(params.cq_entries) { }
+
+	bool map_(io_uring_params const& params) {
+		this->sq_size_ = params.sq_off.array + (params.sq_entries * sizeof(std::uint32_t));
+		this->cq_size_ = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+
+		auto const single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if(single) {
+			this->sq_size_ = this->cq_size_ = std::max(this->sq_size_, this->cq_size_);
+		}
+
+		auto const map = [this](std::size_t size, off_t offset) -> void* {
+			auto* const p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd_, offset);
+			return p == MAP_FAILED ? nullptr : p;
+		};
+
+		this->sq_ptr_ = map(this->sq_size_, IORING_OFF_SQ_RING);
+		if(this->sq_ptr_ == nullptr) {
+			return false;
+		}
+
+		this->cq_ptr_ = single ? this->sq_ptr_ : map(this->cq_size_, IORING_OFF_CQ_RING);
+		if(this->cq_ptr_ == nullptr) {
+			return false;
+		}
+
+		this->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+		this->sqes_      = static_cast<io_uring_sqe*>(map(this->sqes_size_, IORING_OFF_SQES));
+		if(this->sqes_ == nullptr) {
+			return false;
+		}
+
+		auto* const sq = static_cast<char*>(this->sq_ptr_);
+		auto* const cq = static_cast<char*>(this->cq_ptr_);
+
+		this->sq_head_  = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.head);
+		this->sq_tail_  = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.tail);
+		this->sq_mask_  = *reinterpret_cast<std::uint32_t*>(sq + params.sq_off.ring_mask);
+		this->sq_array_ = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.array);
+		this->cq_head_  = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.head);
+		this->cq_tail_  = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.tail);
+		this->cq_mask_  = *reinterpret_cast<std::uint32_t*>(cq + params.cq_off.ring_mask);
+		this->cqes_     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		return true;
+	}
+
+	void push_(std::function<void(io_uring_sqe&)> prepare, std::function<void(int)> done) {
+		auto op = std::make_unique<Op_>(Op_{.prepare = std::move(prepare), .done = std::move(done)});
+
+		std::lock_guard const lock(this->mutex_);
+		if(!this->pending_.empty() || !this->has_room_()) {
+			this->pending_.push_back(std::move(op));
+			return;
+		}
+
+		this->submit_(std::move(op));
+		this->enter_();
+	}
+
+	// Operations in flight are bounded by the completion queue so that no completion overflows it.
+	[[nodiscard]] bool has_room_() const noexcept {
+		auto const queued = *this->sq_tail_ - std::atomic_ref(*this->sq_head_).load(std::memory_order_acquire);
+		return this->in_flight_ < this->cq_entries_ && queued < this->sq_entries_;
+	}
+
+	// Requires `mutex_` to be locked.
+	void submit_(std::unique_ptr<Op_> op) {
+		auto const tail = *this->sq_tail_;
+		auto const i    = tail & this->sq_mask_;
+
+		auto& sqe = this->sqes_[i];
+		sqe       = io_uring_sqe{};
+		if(op) {
+			op->prepare(sqe);
+		} else {
+			sqe.opcode = IORING_OP_NOP;
+		}
+		sqe.user_data = reinterpret_cast<std::uintptr_t>(op.release());
+
+		this->sq_array_[i] = i;
+		std::atomic_ref(*this->sq_tail_).store(tail + 1, std::memory_order_release);
+		++this->in_flight_;
+	}
+
+	// Requires `mutex_` to be locked.
+	// Entries the kernel did not take, e.g. for lack of memory, are submitted by the next call.
+	void enter_() {
+		auto const n = *this->sq_tail_ - std::atomic_ref(*this->sq_head_).load(std::memory_order_acquire);
+		while(n > 0 && ::syscall(__NR_io_uring_enter, this->fd_, n, 0, 0, nullptr, 0) < 0 && errno == EINTR) { }
+	}
+
+	void reap_() {
+		std::vector<std::pair<std::unique_ptr<Op_>, int>> completions;
+
+		auto stopped = false;
+		while(!stopped) {
+			// Fails only if interrupted or the kernel is short of memory, in which case it is just retried.
+			::syscall(__NR_io_uring_enter, this->fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+			{
+				// Taken before the completions are read, so they are ordered after their submissions
+				// for the threads of this process and not only through the kernel.
+				std::lock_guard const lock(this->mutex_);
+
+				auto       head = *this->cq_head_;
+				auto const tail = std::atomic_ref(*this->cq_tail_).load(std::memory_order_acquire);
+				for(; head != tail; ++head) {
+					auto const& cqe = this->cqes_[head & this->cq_mask_];
+					completions.emplace_back(reinterpret_cast<Op_*>(cqe.user_data), cqe.res);
+				}
+				std::atomic_ref(*this->cq_head_).store(head, std::memory_order_release);
+
+				this->in_flight_ -= static_cast<std::uint32_t>(completions.size());
+				while(!this->pending_.empty() && this->has_room_()) {
+					this->submit_(std::move(this->pending_.front()));
+					this->pending_.pop_front();
+				}
+				this->enter_();
+			}
+
+			for(auto& [op, res]: completions) {
+				if(op) {
+					op->done(res);
+				} else {
+					stopped = true;
+				}
+			}
+			completions.clear();
+		}
+	}
+
+	int fd_;
+
+	std::uint32_t sq_entries_;
+	std::uint32_t cq_entries_;
+
+	void*         sq_ptr_    = nullptr;
+	void*         cq_ptr_    = nullptr;
+	io_uring_sqe* sqes_      = nullptr;
+	std::size_t   sq_size_   = 0;
+	std::size_t   cq_size_   = 0;
+	std::size_t   sqes_size_ = 0;
+
+	std::uint32_t* sq_head_  = nullptr;
+	std::uint32_t* sq_tail_  = nullptr;
+	std::uint32_t* sq_array_ = nullptr;
+	std::uint32_t  sq_mask_  = 0;
+	std::uint32_t* cq_head_  = nullptr;
+	std::uint32_t* cq_tail_  = nullptr;
+	io_uring_cqe*  cqes_     = nullptr;
+	std::uint32_t  cq_mask_  = 0;
+
+	std::mutex                       mutex_;
+	std::uint32_t                    in_flight_ = 0;
+	std::deque<std::unique_ptr<Op_>> pending_;
+
+	std::jthread reaper_;
+};
+
+#else
+
+class IoEngine::Ring_ {
+   public:
+	static std::unique_ptr<Ring_> make(unsigned /*entries*/) {
+		return nullptr;
+	}
+
+	void open(fs::path /*p*/, int /*flags*/, std::function<void(int)> done) {
+		done(-ENOSYS);
+	}
+
+	void read(int /*fd*/, std::span<char> /*buf*/, std::function<void(int)> done) {
+		done(-ENOSYS);
+	}
+
+	void write(int /*fd*/, std::span<char const> /*buf*/, std::function<void(int)> done) {
+		done(-ENOSYS);
+	}
+
+	void stat(fs::path /*p*/, std::function<void(int, unsigned)> done) {
+		done(-ENOSYS, 0);
+	}
+};
+
+#endif
+
+struct IoEngine::Reading_ {
+	Reading_() = default;
+
+	Reading_(Reading_ const& other) = delete;
+	Reading_(Reading_&& other)      = delete;
+
+	~Reading_() {
+		if(this->fd >= 0) {
+			::close(this->fd);
+		}
+	}
+
+	Reading_& operator=(Reading_ const& other) = delete;
+	Reading_& operator=(Reading_&& other)      = delete;
+
+	std::function<void(std::error_code, std::string)> callback;
+
+	int         fd = -1;
+	std::string data;
+	std::size_t n = 0;
+
+	std::array<char, 256> probe{};
+};
+
+struct IoEngine::Writing_ {
+	Writing_() = default;
+
+	Writing_(Writing_ const& other) = delete;
+	Writing_(Writing_&& other)      = delete;
+
+	~Writing_() {
+		if(this->fd >= 0) {
+			::close(this->fd);
+		}
+	}
+
+	Writing_& operator=(Writing_ const& other) = delete;
+	Writing_& operator=(Writing_&& other)      = delete;
+
+	std::function<void(std::error_code)> callback;
+
+	int         fd = -1;
+	std::string data;
+	std::size_t n = 0;
+};
+
+namespace {
+
+std::error_code error_of_(int res) {
+	return {-res, std::generic_category()};
+}
+
+}  // namespace
+
+IoEngine::IoEngine(std::size_t concurrency)
+    : ring_(Ring_::make(256)) {
+	this->workers_.reserve(concurrency);
+	for(std::size_t i = 0; i < concurrency; ++i) {
+		this->workers_.emplace_back([this](std::stop_token const& stop) { this->run_(stop); });
+	}
+}
+
+IoEngine::~IoEngine() = default;
+
+IoEngine& IoEngine::instance() {
+	static IoEngine engine(std::max(4U, std::thread::hardware_concurrency()));
+	return engine;
+}
+
+void IoEngine::submit(std::function<void()> job) {
+	{
+		std::lock_guard const lock(this->mutex_);
+		this->jobs_.emplace_back(std::move(job));
+	}
+
+	this->cv_.notify_one();
+}
+
+void IoEngine::read_file(fs::path p, std::function<void(std::error_code, std::string)> callback) {
+	if(!this->ring_) {
+		this->submit([p = std::move(p), callback = std::move(callback)] {
+			std::error_code ec;
+
+			auto data = handle_error([&] { return read_os_file(p); }, ec);
+			callback(ec, std::move(data));
+		});
+		return;
+	}
+
+	auto r      = std::make_shared<Reading_>();
+	r->callback = std::move(callback);
+	this->ring_->open(std::move(p), O_RDONLY, [this, r](int res) mutable {
+		if(res < 0) {
+			this->submit([r = std::move(r), res] { r->callback(error_of_(res), {}); });
+			return;
+		}
+
+		r->fd = res;
+
+		struct stat st { };
+
+		if(::fstat(r->fd, &st) != 0) {
+			res = -errno;
+		} else if(S_ISDIR(st.st_mode)) {
+			res = -EISDIR;
+		}
+		if(res < 0) {
+			this->submit([r = std::move(r), res] { r->callback(error_of_(res), {}); });
+			return;
+		}
+
+		// The size is a hint as `read_os_file` takes it.
+		r->data.resize(st.st_size);
+		this->read_(std::move(r));
+	});
+}
+
+void IoEngine::read_(std::shared_ptr<Reading_> r) {
+	// Probes for EOF without growing the string once the hinted size is read.
+	auto const probing = r->n == r->data.size();
+	auto const buf     = probing ? std::span<char>(r->probe) : std::span<char>(r->data).subspan(r->n);
+	this->ring_->read(r->fd, buf, [this, r, probing](int res) mutable {
+		if(res == -EINTR || res == -EAGAIN) {
+			this->read_(std::move(r));
+			return;
+		}
+		if(res < 0) {
+			this->submit([r = std::move(r), res] { r->callback(error_of_(res), {}); });
+			return;
+		}
+		if(res == 0) {
+			r->data.resize(r->n);
+			this->submit([r = std::move(r)] { r->callback({}, std::move(r->data)); });
+			return;
+		}
+
+		auto const k = static_cast<std::size_t>(res);
+		if(probing) {
+			r->data.resize(std::max(r->data.size() * 2, r->n + k));
+			std::copy_n(r->probe.data(), k, r->data.data() + r->n);
+		}
+
+		r->n += k;
+		this->read_(std::move(r));
+	});
+}
+
+void IoEngine::write_file(fs::path p, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) {
+	auto const append = (mode & std::ios_base::app) == std::ios_base::app;
+	if(!this->ring_) {
+		this->submit([p = std::move(p), data = std::move(data), mode, callback = std::move(callback)] {
+			std::error_code ec;
+			handle_error([&] { write_os_file(p, data, mode); return 0; }, ec);
+			callback(ec);
+		});
+		return;
+	}
+
+	auto w      = std::make_shared<Writing_>();
+	w->callback = std::move(callback);
+	w->data     = std::move(data);
+	this->ring_->open(std::move(p), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), [this, w](int res) mutable {
+		if(res < 0) {
+			this->submit([w = std::move(w), res] { w->callback(error_of_(res)); });
+			return;
+		}
+
+		w->fd = res;
+		this->write_(std::move(w));
+	});
+}
+
+void IoEngine::write_(std::shared_ptr<Writing_> w) {
+	if(w->n == w->data.size()) {
+		this->submit([w = std::move(w)] { w->callback({}); });
+		return;
+	}
+
+	auto const buf = std::span<char const>(w->data).subspan(w->n);
+	this->ring_->write(w->fd, buf, [this, w](int res) mutable {
+		if(res < 0 && res != -EINTR && res != -EAGAIN) {
+			this->submit([w = std::move(w), res] { w->callback(error_of_(res)); });
+			return;
+		}
+		if(res > 0) {
+			w->n += static_cast<std::size_t>(res);
+		}
+
+		this->write_(std::move(w));
+	});
+}
+
+void IoEngine::status(fs::path p, std::function<void(std::error_code, fs::file_status)> callback) {
+	if(!this->ring_) {
+		this->submit([p = std::move(p), callback = std::move(callback)] {
+			std::error_code ec;
+
+			auto const s = fs::status(p, ec);
+			if(s.type() == fs::file_type::not_found) {
+				ec.clear();
+			}
+			callback(ec, s);
+		});
+		return;
+	}
+
+	this->ring_->stat(std::move(p), [this, callback = std::move(callback)](int res, unsigned mode) mutable {
+		std::error_code ec;
+
+		auto s = fs::file_status(fs::file_type::not_found);
+		if(res >= 0) {
+			s = fs::file_status(os_file_type_of(mode), static_cast<fs::perms>(mode) & fs::perms::mask);
+		} else if(res != -ENOENT && res != -ENOTDIR) {
+			s  = fs::file_status(fs::file_type::none);
+			ec = error_of_(res);
+		}
+
+		this->submit([callback = std::move(callback), ec, s] { callback(ec, s); });
+	});
+}
+
+void IoEngine::run_(std::stop_token const& stop) {
+	while(true) {
+		std::function<void()> job;
+		{
+			std::unique_lock lock(this->mutex_);
+			if(!this->cv_.wait(lock, stop, [this] { return !this->jobs_.empty(); })) {
+				return;
+			}
+
+			job = std::move(this->jobs_.front());
+			this->jobs_.pop_front();
+		}
+
+		job();
+	}
+}
+
+}  // namespace impl
+}  // namespace vfs
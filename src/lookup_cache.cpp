@@ -0,0 +1,99 @@
+#include "vfs/impl/lookup_cache.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace vfs {
+namespace impl {
+
+void ChangeWatch::add(std::shared_ptr<ChangeCounter const> counter) {
+	// Directories of a tree may share a counter; the first read is the one to compare with.
+	auto const it = std::find_if(this->entries_.begin(), this->entries_.end(), [&](Entry_ const& entry) {
+		return entry.counter == counter;
+	});
+	if(it != this->entries_.end()) {
+		return;
+	}
+
+	auto const insertions = counter->insertions();
+	auto const removals   = counter->removals();
+	this->entries_.push_back(Entry_{
+	    .counter    = std::move(counter),
+	    .insertions = insertions,
+	    .removals   = removals,
+	});
+}
+
+bool ChangeWatch::removed() const noexcept {
+	return std::any_of(this->entries_.begin(), this->entries_.end(), [](Entry_ const& entry) {
+		return entry.counter->removals() != entry.removals;
+	});
+}
+
+bool ChangeWatch::changed() const noexcept {
+	return std::any_of(this->entries_.begin(), this->entries_.end(), [](Entry_ const& entry) {
+		return entry.counter->removals() != entry.removals || entry.counter->insertions() != entry.insertions;
+	});
+}
+
+std::optional<LookupCache::Record> LookupCache::find(std::string_view key, bool followed) const {
+	std::shared_lock const lock(this->mutex_);
+
+	auto const& records = this->records_of_(followed);
+
+	auto const it = records.find(key);
+	if(it == records.end()) {
+		return std::nullopt;
+	}
+
+	auto const& [record, watch] = it->second;
+	if(record.ec ? watch.changed() : watch.removed()) {
+		return std::nullopt;
+	}
+
+	return record;
+}
+
+void LookupCache::insert(std::string_view key, bool followed, std::shared_ptr<File> const& file, ChangeWatch watch) {
+	// A removal during the lookup may have made it resolve to a file that is no longer there.
+	if(watch.removed()) {
+		return;
+	}
+
+	this->insert_(key, followed, Entry_{
+	    .record = Record{.file = file, .ec = {}, .error = nullptr},
+	    .watch  = std::move(watch),
+	});
+}
+
+void LookupCache::insert(std::string_view key, bool followed, std::error_code ec, std::exception_ptr error, ChangeWatch watch) {
+	if(watch.changed()) {
+		return;
+	}
+
+	this->insert_(key, followed, Entry_{
+	    .record = Record{.file = {}, .ec = ec, .error = std::move(error)},
+	    .watch  = std::move(watch),
+	});
+}
+
+void LookupCache::insert_(std::string_view key, bool followed, Entry_ entry) {
+	std::unique_lock const lock(this->mutex_);
+	if(this->records_.size() + this->followed_records_.size() >= MaxRecords) {
+		this->records_.clear();
+		this->followed_records_.clear();
+	}
+
+	this->records_of_(followed).insert_or_assign(std::string(key), std::move(entry));
+}
+
+}  // namespace impl
+}  // namespace vfs
@@ -1,40 +1,536 @@
 #include "vfs/impl/mem_file.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <memory>
+#include <span>
 #include <sstream>
-#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <utility>
 
+#include "vfs/impl/file_proxy.hpp"
+#include "vfs/impl/lookup_cache.hpp"
+
 namespace fs = std::filesystem;
 
 namespace vfs {
 namespace impl {
 
+// Slots are in blocks that never move, so the slots held by a buffer are read while other slots are appended.
+// Block `b` holds `FirstBlockSize << b` slots.
+class PagedBuffer::Spine_ {
+   public:
+	Spine_() = default;
+
+	Spine_(Spine_ const& other) = delete;
+	Spine_(Spine_&& other)      = delete;
+
+	~Spine_() {
+		for(auto& block: this->blocks_) {
+			delete[] block.load(std::memory_order_relaxed);  // NOLINT(cppcoreguidelines-owning-memory)
+		}
+	}
+
+	Spine_& operator=(Spine_ const& other) = delete;
+	Spine_& operator=(Spine_&& other)      = delete;
+
+	[[nodiscard]] std::shared_ptr<std::string> const& at(std::size_t i) const {
+		auto const [b, o] = locate_(i);
+		return this->blocks_[b].load(std::memory_order_acquire)[o];
+	}
+
+	// Puts `page` at `i` unless a page was already put there or after it through any buffer sharing the spine.
+	bool try_push(std::size_t i, std::shared_ptr<std::string>& page) {
+		auto expected = i;
+		if(!this->count_.compare_exchange_strong(expected, i + 1, std::memory_order_acq_rel)) {
+			return false;
+		}
+
+		this->slot_(i) = std::move(page);
+		return true;
+	}
+
+	// Only for the buffer that solely owns the spine.
+	void set(std::size_t i, std::shared_ptr<std::string> page) {
+		this->slot_(i) = std::move(page);
+	}
+
+	// Only for the buffer that solely owns the spine.
+	void truncate(std::size_t n) {
+		auto const count = this->count_.load(std::memory_order_relaxed);
+		for(auto i = n; i < count; ++i) {
+			this->slot_(i).reset();
+		}
+		this->count_.store(std::min(n, count), std::memory_order_relaxed);
+	}
+
+   private:
+	static constexpr std::size_t FirstBlockSize = 64;
+
+	static std::pair<std::size_t, std::size_t> locate_(std::size_t i) {
+		auto const b = static_cast<std::size_t>(std::bit_width(i / FirstBlockSize + 1) - 1);
+		return {b, i - FirstBlockSize * ((std::size_t(1) << b) - 1)};
+	}
+
+	std::shared_ptr<std::string>& slot_(std::size_t i) {
+		auto const [b, o] = locate_(i);
+
+		auto& block = this->blocks_[b];
+		auto* slots = block.load(std::memory_order_acquire);
+		if(slots == nullptr) {
+			// Another buffer may be putting a page into the same block.
+			auto* const allocated = new std::shared_ptr<std::string>[FirstBlockSize << b];  // NOLINT(cppcoreguidelines-owning-memory)
+			if(block.compare_exchange_strong(slots, allocated, std::memory_order_acq_rel)) {
+				slots = allocated;
+			} else {
+				delete[] allocated;  // NOLINT(cppcoreguidelines-owning-memory)
+			}
+		}
+
+		return slots[o];
+	}
+
+	std::array<std::atomic<std::shared_ptr<std::string>*>, 48> blocks_{};
+
+	// Number of slots put.
+	std::atomic<std::size_t> count_ = 0;
+};
+
+std::string_view PagedBuffer::page(std::size_t i) const {
+	assert(i < this->page_count());
+
+	if(i < this->full_page_count_()) {
+		return {this->spine_->at(i)->data(), PageSize};
+	}
+
+	return {this->tail_->data(), this->size_ % PageSize};
+}
+
+std::size_t PagedBuffer::read(std::size_t offset, std::span<char> buf) const {
+	std::size_t n = 0;
+	while(n < buf.size() && offset < this->size_) {
+		auto const page = this->page(offset / PageSize).substr(offset % PageSize);
+		auto const k    = std::min(page.size(), buf.size() - n);
+		std::copy_n(page.data(), k, buf.data() + n);
+
+		n += k;
+		offset += k;
+	}
+
+	return n;
+}
+
+std::span<char> PagedBuffer::reserve(std::size_t n) {
+	auto const used = this->size_ % PageSize;
+	if(!this->tail_) {
+		assert(used == 0);
+
+		this->tail_ = std::make_shared<std::string>();
+		this->tail_->resize(std::clamp(n, MinPageCapacity_, PageSize));
+	}
+
+	auto& page = this->tail_;
+	if(page.use_count() > 1) {
+		page = std::make_shared<std::string>(page->data(), used);
+	}
+	if(page->size() - used < n && page->size() < PageSize) {
+		page->resize(std::clamp(std::max(used + n, page->size() * 2), MinPageCapacity_, PageSize));
+	}
+
+	assert(used < page->size());
+	return {page->data() + used, page->size() - used};
+}
+
+void PagedBuffer::grow(std::size_t n) {
+	assert(n <= PageSize - this->size_ % PageSize);
+	if(n == 0) {
+		return;
+	}
+
+	this->size_ += n;
+	if(this->size_ % PageSize == 0) {
+		this->seal_(std::move(this->tail_));
+	}
+}
+
+void PagedBuffer::append(std::string_view data) {
+	while(!data.empty()) {
+		auto const space = this->reserve(data.size());
+		auto const n     = std::min(space.size(), data.size());
+		std::copy_n(data.data(), n, space.data());
+		this->grow(n);
+		data.remove_prefix(n);
+	}
+}
+
+void PagedBuffer::write(std::size_t offset, std::string_view data) {
+	if(offset > this->size_) {
+		this->resize(offset);
+	}
+
+	while(!data.empty() && offset < this->size_) {
+		auto const i = offset / PageSize;
+		auto const o = offset % PageSize;
+		auto const n = std::min(data.size(), this->page(i).size() - o);
+
+		if(i < this->full_page_count_()) {
+			auto const& page = this->spine_->at(i);
+			if(this->spine_.use_count() == 1 && page.use_count() == 1) {
+				std::copy_n(data.data(), n, page->data() + o);
+			} else {
+				auto next = std::make_shared<std::string>(*page);
+				std::copy_n(data.data(), n, next->data() + o);
+				this->replace_(i, std::move(next));
+			}
+		} else {
+			auto& page = this->tail_;
+			if(page.use_count() > 1) {
+				page = std::make_shared<std::string>(*page);
+			}
+			std::copy_n(data.data(), n, page->data() + o);
+		}
+
+		offset += n;
+		data.remove_prefix(n);
+	}
+
+	this->append(data);
+}
+
+void PagedBuffer::append(PagedBuffer const& other) {
+	if(this->size_ % PageSize != 0) {
+		for(std::size_t i = 0; i < other.page_count(); ++i) {
+			this->append(other.page(i));
+		}
+		return;
+	}
+
+	for(std::size_t i = 0; i < other.full_page_count_(); ++i) {
+		this->size_ += PageSize;
+		this->seal_(other.spine_->at(i));
+	}
+
+	this->tail_ = other.tail_;
+	this->size_ += other.size_ % PageSize;
+}
+
+void PagedBuffer::resize(std::size_t n) {
+	if(n <= this->size_) {
+		auto const prev_full = this->full_page_count_();
+
+		this->size_     = n;
+		auto const full = this->full_page_count_();
+		if(n % PageSize == 0) {
+			this->tail_ = nullptr;
+		} else if(full < prev_full) {
+			this->tail_ = this->spine_->at(full);
+		}
+		if(this->spine_ && this->spine_.use_count() == 1) {
+			this->spine_->truncate(full);
+		}
+		return;
+	}
+
+	while(this->size_ < n) {
+		auto const space = this->reserve(n - this->size_);
+		auto const k     = std::min(space.size(), n - this->size_);
+		std::fill_n(space.data(), k, '\0');
+		this->grow(k);
+	}
+}
+
+void PagedBuffer::seal_(std::shared_ptr<std::string> page) {
+	assert(this->size_ % PageSize == 0);
+
+	auto const i = this->full_page_count_() - 1;
+	if(!this->spine_) {
+		this->spine_ = std::make_shared<Spine_>();
+	} else if(this->spine_.use_count() == 1) {
+		this->spine_->truncate(i);
+	}
+
+	if(this->spine_->try_push(i, page)) {
+		return;
+	}
+
+	// Another copy appended its own page here.
+	this->fork_(i);
+
+	[[maybe_unused]] auto const ok = this->spine_->try_push(i, page);
+	assert(ok);
+}
+
+void PagedBuffer::replace_(std::size_t i, std::shared_ptr<std::string> page) {
+	if(this->spine_.use_count() > 1) {
+		this->fork_(this->full_page_count_());
+	}
+
+	this->spine_->set(i, std::move(page));
+}
+
+void PagedBuffer::fork_(std::size_t n) {
+	auto spine = std::make_shared<Spine_>();
+	for(std::size_t i = 0; i < n; ++i) {
+		auto page = this->spine_->at(i);
+		spine->try_push(i, page);
+	}
+
+	this->spine_ = std::move(spine);
+}
+
+namespace {
+
+// Reads the snapshot in place; the snapshot is never modified while it is shared.
+class SnapshotBuf_: public std::streambuf {
+   public:
+	SnapshotBuf_(std::shared_ptr<PagedBuffer const> data)
+	    : data_(std::move(data)) {
+		this->load_(0, 0);
+	}
+
+   protected:
+	int_type underflow() override {
+		if(this->gptr() < this->egptr()) {
+			return traits_type::to_int_type(*this->gptr());
+		}
+		if(this->index_ + 1 >= this->data_->page_count()) {
+			return traits_type::eof();
+		}
+
+		this->load_(this->index_ + 1, 0);
+		return traits_type::to_int_type(*this->gptr());
+	}
+
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+		if((which & std::ios_base::in) == 0) {
+			return pos_type(off_type(-1));
+		}
+
+		auto const size = static_cast<off_type>(this->data_->size());
+
+		off_type base = 0;
+		switch(dir) {
+		case std::ios_base::beg: {
+			break;
+		}
+		case std::ios_base::cur: {
+			base = this->pos_();
+			break;
+		}
+		case std::ios_base::end: {
+			base = size;
+			break;
+		}
+
+		default: {
+			return pos_type(off_type(-1));
+		}
+		}
+
+		auto const pos = base + off;
+		if(pos < 0 || pos > size) {
+			return pos_type(off_type(-1));
+		}
+
+		auto const p = static_cast<std::size_t>(pos);
+		if(p == this->data_->size() && p > 0 && p % PagedBuffer::PageSize == 0) {
+			// End of the last page.
+			this->load_(p / PagedBuffer::PageSize - 1, PagedBuffer::PageSize);
+		} else {
+			this->load_(p / PagedBuffer::PageSize, p % PagedBuffer::PageSize);
+		}
+
+		return pos_type(pos);
+	}
+
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+		return this->seekoff(off_type(pos), std::ios_base::beg, which);
+	}
+
+	std::streamsize showmanyc() override {
+		auto const n = static_cast<off_type>(this->data_->size()) - this->pos_();
+		return n > 0 ? n : -1;
+	}
+
+   private:
+	void load_(std::size_t i, std::size_t offset) {
+		this->index_ = i;
+		if(i >= this->data_->page_count()) {
+			this->setg(nullptr, nullptr, nullptr);
+			return;
+		}
+
+		auto const page = this->data_->page(i);
+		auto* const b    = const_cast<char*>(page.data());
+		this->setg(b, b + offset, b + page.size());
+	}
+
+	[[nodiscard]] off_type pos_() const {
+		return static_cast<off_type>(this->index_ * PagedBuffer::PageSize) + (this->gptr() - this->eback());
+	}
+
+	std::shared_ptr<PagedBuffer const> data_;
+
+	std::size_t index_ = 0;
+};
+
+class SnapshotStream_: public std::istream {
+   public:
+	SnapshotStream_(std::shared_ptr<PagedBuffer const> data)
+	    : std::istream(nullptr)
+	    , buf_(std::move(data)) {
+		this->rdbuf(&this->buf_);
+	}
+
+   private:
+	SnapshotBuf_ buf_;
+};
+
+}  // namespace
+
+template<typename F>
+void MemRegularFile::update_(F const& f) {
+	auto curr = this->data_.load();
+	while(true) {
+		auto next = std::make_shared<PagedBuffer>(*curr);
+		f(*next);
+
+		// Retries if other writer published in the meantime.
+		if(this->data_.compare_exchange_weak(curr, std::shared_ptr<PagedBuffer const>(std::move(next)))) {
+			return;
+		}
+	}
+}
+
+// Writes into pages owned by the stream, which are published to the file on commit
+// so that readers never see a partial write.
+class MemRegularFile::WriteBuf_: public std::streambuf {
+   public:
+	WriteBuf_(std::weak_ptr<MemRegularFile> file, bool append)
+	    : file_(std::move(file))
+	    , append_(append) { }
+
+	WriteBuf_(WriteBuf_ const& other) = delete;
+	WriteBuf_(WriteBuf_&& other)      = delete;
+
+	~WriteBuf_() override {
+		this->commit();
+	}
+
+	WriteBuf_& operator=(WriteBuf_ const& other) = delete;
+	WriteBuf_& operator=(WriteBuf_&& other)      = delete;
+
+	// Publishes the data written so far; subsequent writes are appended to it.
+	void commit() {
+		this->data_.grow(this->pptr() - this->pbase());
+		this->setp(nullptr, nullptr);
+
+		auto data   = std::move(this->data_);
+		this->data_ = PagedBuffer();
+		if(this->append_ && data.size() == 0) {
+			// Nothing new since the last commit.
+			return;
+		}
+
+		auto f = this->file_.lock();
+		if(!f) {
+			return;
+		}
+
+		if(!this->append_) {
+			f->data_.store(std::make_shared<PagedBuffer const>(std::move(data)));
+			this->append_ = true;
+		} else {
+			f->update_([&data](PagedBuffer& d) { d.append(data); });
+		}
+
+		f->last_write_time(fs::file_time_type::clock::now());
+	}
+
+   protected:
+	int_type overflow(int_type c) override {
+		if(traits_type::eq_int_type(c, traits_type::eof())) {
+			return traits_type::not_eof(c);
+		}
+
+		this->data_.grow(this->pptr() - this->pbase());
+
+		auto const space = this->data_.reserve(1);
+		this->setp(space.data(), space.data() + space.size());
+
+		*this->pptr() = traits_type::to_char_type(c);
+		this->pbump(1);
+		return c;
+	}
+
+	int sync() override {
+		this->commit();
+		return 0;
+	}
+
+   private:
+	std::weak_ptr<MemRegularFile> file_;
+
+	// The put area is the space reserved at its end.
+	PagedBuffer data_;
+
+	bool append_;
+};
+
 MemRegularFile::MemRegularFile(fs::perms perms)
     : VFile(perms)
-    , data_(std::make_shared<std::string>()) { }
+    , data_(std::make_shared<PagedBuffer const>()) { }
 
 MemRegularFile::MemRegularFile(MemRegularFile const& other)
     : VFile(other)
-    , data_(std::make_shared<std::string>(*other.data_)) { }
+    , data_(other.data_.load()) { }
+
+MemRegularFile::MemRegularFile(MemRegularFile&& other) noexcept
+    : VFile(std::move(other))
+    , data_(other.data_.load())
+    , last_write_time_(other.last_write_time()) { }
+
+void MemRegularFile::copy_from(RegularFile const& other) {
+	std::shared_ptr<File const> origin;
+	if(auto const* proxy = dynamic_cast<FileProxy const*>(&other); proxy) {
+		origin = proxy->origin();
+	}
+
+	auto const* f = dynamic_cast<MemRegularFile const*>(origin ? origin.get() : &other);
+	if(f == nullptr) {
+		RegularFile::copy_from(other);
+		return;
+	}
+
+	this->data_.store(f->data_.load());
+	this->last_write_time(fs::file_time_type::clock::now());
+	this->perms(other.perms(), fs::perm_options::replace);
+}
 
 std::uintmax_t MemRegularFile::size() const {
-	assert(nullptr != this->data_);
-	return this->data_->size();
+	return this->data_.load()->size();
 }
 
 void MemRegularFile::resize(std::uintmax_t new_size) {
-	assert(nullptr != this->data_);
-	return this->data_->resize(new_size);
+	this->update_([new_size](PagedBuffer& d) { d.resize(new_size); });
 }
 
 std::shared_ptr<std::istream> MemRegularFile::open_read(std::ios_base::openmode mode) const {
-	return std::make_shared<std::istringstream>(*this->data_, mode);
+	auto s = std::make_shared<SnapshotStream_>(this->data_.load());
+	if((mode & std::ios_base::ate) == std::ios_base::ate) {
+		s->seekg(0, std::ios_base::end);
+	}
+
+	return s;
 }
 
 std::shared_ptr<std::ostream> MemRegularFile::open_write(std::ios_base::openmode mode) {
@@ -57,56 +553,134 @@ std::shared_ptr<std::ostream> MemRegularFile::open_write(std::ios_base::openmode
 	}
 	}
 
-	return std::shared_ptr<std::ostringstream>(new std::ostringstream(), [mode, self = std::weak_ptr(this->shared_from_this())](std::ostringstream* p) {
-		auto data = std::move(*p).str();
+	auto const append = (mode & ios::app) == ios::app;
+
+	auto buf = std::make_unique<WriteBuf_>(this->shared_from_this(), append);
+	auto os  = std::make_unique<std::ostream>(buf.get());
+	return std::shared_ptr<std::ostream>(os.release(), [buf = buf.release()](std::ostream* p) {
 		delete p;
+		delete buf;
+	});
+}
 
-		auto f = self.lock();
-		if(!f) {
-			return;
-		}
+// Reads a snapshot taken for each call and writes by publishing a new snapshot,
+// so it never observes a partial write of others.
+class MemRegularFile::Handle_: public FileHandle {
+   public:
+	Handle_(std::shared_ptr<MemRegularFile> file, bool writable)
+	    : file_(std::move(file))
+	    , writable_(writable) { }
 
-		switch(int(mode)) {
-		case int(ios::out):
-		case int(ios::trunc):
-		case int(ios::out | ios::trunc): {
-			f->data_ = std::make_shared<std::string>(std::move(data));
-			break;
+	std::size_t pread(std::span<char> buf, std::uintmax_t offset) override {
+		auto const data = this->file_->data_.load();
+		if(offset >= data->size()) {
+			return 0;
 		}
 
-		case int(ios::app):
-		case int(ios::out | ios::app): {
-			f->data_->append(std::move(data));
-			break;
-		}
+		return data->read(static_cast<std::size_t>(offset), buf);
+	}
 
-		default: {
-			throw std::logic_error("unreachable");
-		}
+	void pwrite(std::string_view data, std::uintmax_t offset) override {
+		this->must_be_writable_();
+		this->file_->update_([&](PagedBuffer& d) { d.write(static_cast<std::size_t>(offset), data); });
+		this->file_->last_write_time(fs::file_time_type::clock::now());
+	}
+
+	[[nodiscard]] std::uintmax_t size() const override {
+		return this->file_->size();
+	}
+
+	void truncate(std::uintmax_t n) override {
+		this->must_be_writable_();
+		this->file_->resize(n);
+		this->file_->last_write_time(fs::file_time_type::clock::now());
+	}
+
+	void sync() override {
+	}
+
+   private:
+	void must_be_writable_() const {
+		if(!this->writable_) {
+			throw fs::filesystem_error("", std::make_error_code(std::errc::bad_file_descriptor));
 		}
+	}
 
-		f->last_write_time_ = fs::file_time_type::clock::now();
-	});
+	std::shared_ptr<MemRegularFile> file_;
+
+	bool writable_;
+};
+
+std::string MemRegularFile::read_all() const {
+	auto const data = this->data_.load();
+
+	std::string s;
+	s.reserve(data->size());
+	for(std::size_t i = 0; i < data->page_count(); ++i) {
+		s += data->page(i);
+	}
+
+	return s;
+}
+
+std::size_t MemRegularFile::read_at(std::uintmax_t offset, std::span<char> buf) const {
+	auto const data = this->data_.load();
+	if(offset >= data->size()) {
+		return 0;
+	}
+
+	return data->read(static_cast<std::size_t>(offset), buf);
+}
+
+void MemRegularFile::write_all(std::string_view data, std::ios_base::openmode mode) {
+	if((mode & std::ios_base::app) == std::ios_base::app) {
+		this->update_([data](PagedBuffer& d) { d.append(data); });
+	} else {
+		auto d = std::make_shared<PagedBuffer>();
+		d->append(data);
+		this->data_.store(std::move(d));
+	}
+
+	this->last_write_time(fs::file_time_type::clock::now());
+}
+
+std::shared_ptr<FileHandle> MemRegularFile::open_handle(std::ios_base::openmode mode) {
+	auto const writable = (mode & std::ios_base::out) == std::ios_base::out;
+	if(writable && (mode & std::ios_base::trunc) == std::ios_base::trunc) {
+		this->data_.store(std::make_shared<PagedBuffer const>());
+		this->last_write_time(fs::file_time_type::clock::now());
+	}
+
+	return std::make_shared<Handle_>(this->shared_from_this(), writable);
 }
 
 MemRegularFile& MemRegularFile::operator=(MemRegularFile const& other) {
-	assert(nullptr != this->data_);
-	assert(nullptr != other.data_);
+	this->data_.store(other.data_.load());
+	this->last_write_time(fs::file_time_type::clock::now());
+	return *this;
+}
 
-	*this->data_           = *other.data_;
-	this->last_write_time_ = fs::file_time_type::clock::now();
+MemRegularFile& MemRegularFile::operator=(MemRegularFile&& other) noexcept {
+	VFile::operator=(std::move(other));
+	this->data_.store(other.data_.load());
+	this->last_write_time(other.last_write_time());
 	return *this;
 }
 
-std::pair<std::shared_ptr<RegularFile>, bool> MemDirectory::emplace_regular_file(std::string const& name) {
-	auto [it, ok] = this->files_.emplace(name, std::make_shared<MemRegularFile>());
-	return std::make_pair(std::dynamic_pointer_cast<RegularFile>(it->second), ok);
+template<typename Files>
+std::pair<std::shared_ptr<RegularFile>, bool> BasicMemDirectory<Files>::emplace_regular_file(std::string const& name) {
+	auto [f, ok] = this->emplace_(name, [] { return std::make_shared<MemRegularFile>(); });
+	return std::make_pair(std::dynamic_pointer_cast<RegularFile>(std::move(f)), ok);
 }
 
-std::pair<std::shared_ptr<Directory>, bool> MemDirectory::emplace_directory(std::string const& name) {
-	auto [it, ok] = this->files_.emplace(name, std::make_shared<MemDirectory>());
-	return std::make_pair(std::dynamic_pointer_cast<Directory>(it->second), ok);
+template<typename Files>
+std::pair<std::shared_ptr<Directory>, bool> BasicMemDirectory<Files>::emplace_directory(std::string const& name) {
+	auto [f, ok] = this->emplace_(name, [this] { return std::make_shared<BasicMemDirectory>(Directory::DefaultPerms, this->concurrent()); });
+	return std::make_pair(std::dynamic_pointer_cast<Directory>(std::move(f)), ok);
 }
 
+template class BasicMemDirectory<HashedFiles>;
+template class BasicMemDirectory<SortedFiles>;
+
 }  // namespace impl
 }  // namespace vfs
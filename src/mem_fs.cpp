@@ -14,4 +14,18 @@ std::shared_ptr<Fs> make_mem_fs(fs::path const& temp_dir) {
 	return std::make_shared<impl::Vfs>(std::move(d), temp_dir);
 }
 
+std::shared_ptr<Fs> make_mem_fs(fs::path const& temp_dir, VfsOptions const& opts) {
+	std::shared_ptr<impl::Directory> d;
+	if(opts.sorted_directories) {
+		d = std::make_shared<impl::SortedMemDirectory>(impl::Directory::DefaultPerms, opts.concurrent);
+	} else {
+		d = std::make_shared<impl::MemDirectory>(impl::Directory::DefaultPerms, opts.concurrent);
+	}
+
+	auto vfs = std::make_shared<impl::Vfs>(std::make_shared<impl::DirectoryEntry>("/", nullptr, std::move(d)), temp_dir);
+	vfs->apply(opts);
+
+	return vfs;
+}
+
 }  // namespace vfs
@@ -6,12 +6,14 @@
 #include <cassert>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include "vfs/impl/entry.hpp"
 #include "vfs/impl/file.hpp"
 #include "vfs/impl/fs.hpp"
 #include "vfs/impl/fs_proxy.hpp"
+#include "vfs/impl/lookup_cache.hpp"
 #include "vfs/impl/mount_point.hpp"
 #include "vfs/impl/utils.hpp"
 
@@ -89,38 +91,42 @@ void OsDirectory::mount(std::string const& name, std::shared_ptr<File> file) {
 	auto const status = fs::status(next_p);
 	test_mount_point_(next_p, status.type(), file->type());
 
-	std::shared_ptr<MountPoint> mount_point;
-
-	auto& mount_points = this->context_->mount_points;
-	if(auto it = mount_points.find(next_p); it == mount_points.end()) {
-		mount_point = make_mount_point_(file, nullptr);
-	} else {
-		mount_point = make_mount_point_(file, it->second);
-	}
-	mount_points.insert(std::make_pair(next_p, std::move(mount_point)));
+	this->context_->update_mount_points([&](OsFile::Context::MountPoints& mount_points) {
+		std::shared_ptr<MountPoint> mount_point;
+		if(auto it = mount_points.find(next_p); it == mount_points.end()) {
+			mount_point = make_mount_point_(file, nullptr);
+		} else {
+			mount_point = make_mount_point_(file, it->second);
+		}
+		mount_points.insert(std::make_pair(next_p, std::move(mount_point)));
+	});
+	this->context_->changes.notify_removed();
 }
 
 void OsDirectory::unmount(std::string const& name) {
 	auto const next_p = this->path_ / name;
 
-	auto& mount_points = this->context_->mount_points;
-	auto  it           = mount_points.find(next_p);
-	if(it == mount_points.end()) {
-		throw err_not_a_mount_point(next_p);
-	}
+	this->context_->update_mount_points([&](OsFile::Context::MountPoints& mount_points) {
+		auto it = mount_points.find(next_p);
+		if(it == mount_points.end()) {
+			throw err_not_a_mount_point(next_p);
+		}
 
-	auto original = it->second->original();
-	if(original == nullptr) {
-		mount_points.erase(it);
-	} else {
-		auto mount_point = std::dynamic_pointer_cast<MountPoint>(std::move(original));
+		auto original = it->second->original();
+		if(original == nullptr) {
+			mount_points.erase(it);
+		} else {
+			auto mount_point = std::dynamic_pointer_cast<MountPoint>(std::move(original));
 
-		// Only the first MountPoint holds nullptr as the original,
-		// and starting from the second MountPoint, it always holds MountPoint as the original.
-		assert(nullptr != mount_point);
+			// Only the first MountPoint holds nullptr as the original,
+			// and starting from the second MountPoint, it always holds MountPoint as the original.
+			assert(nullptr != mount_point);
 
-		it->second = std::move(mount_point);
-	}
+			it->second = std::move(mount_point);
+		}
+	});
+
+	this->context_->changes.notify_removed();
 }
 
 void OsFs::unmount(fs::path const& target) {
@@ -157,7 +163,10 @@ void OsFsProxy<FsBase>::mount(fs::path const& target, Fs& other, fs::path const&
 	}
 }
 
-void VDirectory::mount(std::string const& name, std::shared_ptr<File> file) {
+template<typename Files>
+void BasicVDirectory<Files>::mount(std::string const& name, std::shared_ptr<File> file) {
+	std::unique_lock const lock(this->mutex_);
+
 	auto const it = this->files_.find(name);
 	if(it == this->files_.end()) {
 		throw err_mount_point_does_not_exist("");
@@ -167,9 +176,13 @@ void VDirectory::mount(std::string const& name, std::shared_ptr<File> file) {
 	test_mount_point_("", next->type(), file->type());
 
 	next = make_mount_point_(file, std::move(next));
+	this->changes_->notify_removed();
 }
 
-void VDirectory::unmount(std::string const& name) {
+template<typename Files>
+void BasicVDirectory<Files>::unmount(std::string const& name) {
+	std::unique_lock const lock(this->mutex_);
+
 	auto const it = this->files_.find(name);
 	if(it == this->files_.end()) {
 		throw err_mount_point_does_not_exist("");
@@ -184,8 +197,14 @@ void VDirectory::unmount(std::string const& name) {
 
 	next = mount_point->original();
 	assert(next != nullptr);
+	this->changes_->notify_removed();
 }
 
+template void BasicVDirectory<HashedFiles>::mount(std::string const& name, std::shared_ptr<File> file);
+template void BasicVDirectory<SortedFiles>::mount(std::string const& name, std::shared_ptr<File> file);
+template void BasicVDirectory<HashedFiles>::unmount(std::string const& name);
+template void BasicVDirectory<SortedFiles>::unmount(std::string const& name);
+
 void Vfs::mount(fs::path const& target, Fs& other, fs::path const& source) {
 	auto original   = this->navigate(target)->follow_chain();
 	auto attachment = fs_base(other).file_at(source);
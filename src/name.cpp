@@ -0,0 +1,105 @@
+#include "vfs/impl/name.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace vfs {
+namespace impl {
+
+class Name::Table_ {
+   public:
+	static Table_& instance() {
+		// Never destructed since `Name`s with static storage duration may outlive it.
+		static auto* table = new Table_();
+		return *table;
+	}
+
+	Rep_ const* intern(std::string_view name) {
+		auto const hash  = std::hash<std::string_view>{}(name);
+		auto&      shard = this->shard_of_(hash);
+
+		// Names are mostly interned already, so they are looked up by readers in parallel first.
+		{
+			std::shared_lock const lock(shard.mutex);
+			if(auto const it = shard.reps.find(name); it != shard.reps.end() && acquire_(it->second)) {
+				return it->second;
+			}
+		}
+
+		std::unique_lock const lock(shard.mutex);
+		if(auto const it = shard.reps.find(name); it != shard.reps.end()) {
+			if(acquire_(it->second)) {
+				return it->second;
+			}
+
+			// Being released; its key views the string that is about to be deleted.
+			shard.reps.erase(it);
+		}
+
+		auto const* rep = new Rep_{.str = std::string(name), .hash = hash};  // NOLINT(cppcoreguidelines-owning-memory)
+		shard.reps.emplace(rep->str, rep);
+
+		return rep;
+	}
+
+	void release(Rep_ const* rep) {
+		{
+			auto& shard = this->shard_of_(rep->hash);
+
+			std::unique_lock const lock(shard.mutex);
+
+			// The entry may be replaced by a new `Rep_` of the same name.
+			auto const it = shard.reps.find(rep->str);
+			if(it != shard.reps.end() && it->second == rep) {
+				shard.reps.erase(it);
+			}
+		}
+
+		// No one else can reach it since the lookups that found it are done with the lock.
+		delete rep;  // NOLINT(cppcoreguidelines-owning-memory)
+	}
+
+   private:
+	struct Shard_ {
+		std::shared_mutex mutex;
+
+		std::unordered_map<std::string_view, Rep_ const*> reps;
+	};
+
+	// Counts a new reference unless the last one is gone, in which case `rep` is about to be deleted.
+	static bool acquire_(Rep_ const* rep) noexcept {
+		auto n = rep->refs.load(std::memory_order_relaxed);
+		while(n != 0) {
+			if(rep->refs.compare_exchange_weak(n, n + 1, std::memory_order_relaxed)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	Shard_& shard_of_(std::size_t hash) {
+		return this->shards_[hash % this->shards_.size()];
+	}
+
+	std::array<Shard_, 64> shards_;
+};
+
+Name::Name(std::string_view name)
+    : rep_(Table_::instance().intern(name)) { }
+
+void Name::release_(Rep_ const* rep) noexcept {
+	if(rep->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		Table_::instance().release(rep);
+	}
+}
+
+}  // namespace impl
+}  // namespace vfs
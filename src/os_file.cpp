@@ -1,12 +1,40 @@
 #include "vfs/impl/os_file.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <ios>
+#include <istream>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
 
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+#include "vfs/impl/fd.hpp"
+#include "vfs/impl/file_proxy.hpp"
+#include "vfs/impl/lookup_cache.hpp"
 #include "vfs/impl/utils.hpp"
 #include "vfs/impl/vfile.hpp"
 
@@ -18,18 +46,79 @@ namespace impl {
 namespace {
 
 std::string random_filename_() {
-	constexpr std::uint8_t TempFilenameLength = 32;
-	return random_string(TempFilenameLength, Alphanumeric);
+	return random_string(32, "0123456789abcdefghijklmnopqrstuv");
 }
 
-fs::path temp_directory_() {
-	return std::filesystem::temp_directory_path() / "vfs";
+fs::path const& temp_directory_() {
+	static auto const d = std::filesystem::temp_directory_path() / "vfs";
+	return d;
 }
 
 bool is_in_temp_directory_(fs::path const& p) {
 	return p.parent_path() == temp_directory_();
 }
 
+// Set once the temporary directory is created, and reset if it turns out to be removed.
+std::atomic<bool> temp_directory_exists_ = false;
+
+void ensure_temp_directory_() {
+	if(temp_directory_exists_.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	fs::create_directories(temp_directory_());
+	temp_directory_exists_.store(true, std::memory_order_relaxed);
+}
+
+// Calls `make` with random paths in the temporary directory until it makes a file there.
+template<typename F>
+fs::path make_temp_(F const& make) {
+	while(true) {
+		ensure_temp_directory_();
+
+		auto p = temp_directory_() / random_filename_();
+
+		std::error_code ec;
+		if(make(p, ec)) {
+			return p;
+		}
+		if(ec == std::errc::no_such_file_or_directory) {
+			temp_directory_exists_.store(false, std::memory_order_relaxed);
+			continue;
+		}
+		if(ec != std::errc::file_exists) {
+			throw fs::filesystem_error("", p, ec);
+		}
+	}
+}
+
+#ifdef O_TMPFILE
+// Opens an unnamed file in the temporary directory, to be named through `/proc/self/fd`.
+// Returns -1 if unnamed files are not supported.
+int open_unnamed_temp_() {
+	static auto const has_proc = ::access("/proc/self/fd", X_OK) == 0;
+	if(!has_proc) {
+		return -1;
+	}
+
+	while(true) {
+		ensure_temp_directory_();
+
+		auto const fd = ::open(temp_directory_().c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0666);
+		if(fd >= 0) {
+			return fd;
+		}
+		if(errno == ENOENT) {
+			temp_directory_exists_.store(false, std::memory_order_relaxed);
+			continue;
+		}
+
+		// e.g. EOPNOTSUPP if the file system does not support it, or EMFILE.
+		return -1;
+	}
+}
+#endif
+
 std::shared_ptr<File> make_file_(fs::file_type type, std::shared_ptr<OsFile::Context> context, fs::path const& p) {
 	switch(type) {
 	case fs::file_type::regular:
@@ -44,11 +133,735 @@ std::shared_ptr<File> make_file_(fs::file_type type, std::shared_ptr<OsFile::Con
 	}
 }
 
-class Cursor_: public Directory::Cursor {
+[[noreturn]] void throw_errno_(fs::path const& p) {
+	throw fs::filesystem_error("", p, std::error_code(errno, std::generic_category()));
+}
+
+OsStat to_os_stat_(struct stat const& st) {
+	auto const mtime = std::chrono::seconds(st.st_mtim.tv_sec) + std::chrono::nanoseconds(st.st_mtim.tv_nsec);
+
+	return OsStat{
+	    .type            = os_file_type_of(st.st_mode),
+	    .perms           = static_cast<fs::perms>(st.st_mode) & fs::perms::mask,
+	    .size            = static_cast<std::uintmax_t>(st.st_size),
+	    .last_write_time = fs::file_time_type::clock::from_sys(std::chrono::sys_time<std::chrono::nanoseconds>(mtime)),
+	};
+}
+
+std::size_t pread_(int fd, fs::path const& p, std::span<char> buf, std::uintmax_t offset) {
+	std::size_t n = 0;
+	while(n < buf.size()) {
+		auto const k = ::pread(fd, buf.data() + n, buf.size() - n, static_cast<off_t>(offset + n));
+		if(k < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			throw_errno_(p);
+		}
+		if(k == 0) {
+			break;
+		}
+
+		n += k;
+	}
+
+	return n;
+}
+
+void pwrite_(int fd, fs::path const& p, std::string_view data, std::uintmax_t offset) {
+	while(!data.empty()) {
+		auto const k = ::pwrite(fd, data.data(), data.size(), static_cast<off_t>(offset));
+		if(k < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			throw_errno_(p);
+		}
+
+		offset += k;
+		data.remove_prefix(k);
+	}
+}
+
+class Handle_: public FileHandle {
+   public:
+	Handle_(fs::path p, int flags, std::shared_ptr<OsStatCache> stat)
+	    : p_(std::move(p))
+	    , fd_(this->p_, flags)
+	    , stat_(std::move(stat)) {
+		if((flags & O_ACCMODE) != O_RDONLY) {
+			// A directory fails to be opened for writing.
+			return;
+		}
+
+		struct stat st { };
+
+		if(::fstat(this->fd_.get(), &st) == 0 && S_ISDIR(st.st_mode)) {
+			throw fs::filesystem_error("", this->p_, std::make_error_code(std::errc::is_a_directory));
+		}
+	}
+
+	std::size_t pread(std::span<char> buf, std::uintmax_t offset) override {
+		return pread_(this->fd_.get(), this->p_, buf, offset);
+	}
+
+	void pwrite(std::string_view data, std::uintmax_t offset) override {
+		OsStatCache::Invalidation const invalidation(this->stat_.get());
+		pwrite_(this->fd_.get(), this->p_, data, offset);
+	}
+
+	[[nodiscard]] std::uintmax_t size() const override {
+		struct stat st { };
+
+		if(::fstat(this->fd_.get(), &st) != 0) {
+			throw_errno_(this->p_);
+		}
+
+		return st.st_size;
+	}
+
+	void truncate(std::uintmax_t n) override {
+		OsStatCache::Invalidation const invalidation(this->stat_.get());
+		if(::ftruncate(this->fd_.get(), static_cast<off_t>(n)) != 0) {
+			throw_errno_(this->p_);
+		}
+	}
+
+	void sync() override {
+		if(::fsync(this->fd_.get()) != 0) {
+			throw_errno_(this->p_);
+		}
+	}
+
+   private:
+	fs::path p_;
+	Fd      fd_;
+
+	std::shared_ptr<OsStatCache> stat_;
+};
+
+// Tries `copy_file_range`, which may share extents on filesystems with reflink, then `sendfile`,
+// and then falls back to copying through a buffer.
+// Each method continues from the file offsets left by the previous one.
+void copy_file_(fs::path const& src, fs::path const& dst) {
+	Fd const in(src, O_RDONLY);
+	Fd const out(dst, O_WRONLY | O_TRUNC);
+
+	auto const fail = [&] {
+		throw fs::filesystem_error("", src, dst, std::error_code(errno, std::generic_category()));
+	};
+
+#ifdef __linux__
+	constexpr std::size_t ChunkSize = std::size_t(1) << 30;
+
+	auto use_copy_file_range = true;
+	auto use_sendfile        = true;
+	while(use_copy_file_range || use_sendfile) {
+		ssize_t n = 0;
+		if(use_copy_file_range) {
+			n = ::copy_file_range(in.get(), nullptr, out.get(), nullptr, ChunkSize, 0);
+			if(n < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+				use_copy_file_range = false;
+				continue;
+			}
+		} else {
+			n = ::sendfile(out.get(), in.get(), nullptr, ChunkSize);
+			if(n < 0 && (errno == ENOSYS || errno == EINVAL)) {
+				use_sendfile = false;
+				continue;
+			}
+		}
+
+		if(n == 0) {
+			return;
+		}
+		if(n < 0 && errno != EINTR) {
+			fail();
+		}
+	}
+#endif
+
+	constexpr std::size_t BufferSize = 1 << 20;
+
+	auto const buffer = std::make_unique_for_overwrite<char[]>(BufferSize);
+	while(true) {
+		auto const n = ::read(in.get(), buffer.get(), BufferSize);
+		if(n == 0) {
+			return;
+		}
+		if(n < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			fail();
+		}
+
+		for(ssize_t written = 0; written < n;) {
+			auto const m = ::write(out.get(), buffer.get() + written, n - written);
+			if(m < 0) {
+				if(errno == EINTR) {
+					continue;
+				}
+				fail();
+			}
+
+			written += m;
+		}
+	}
+}
+
+// Reads a mapping in place; the whole file is the get area.
+class MappedBuf_: public std::streambuf {
    public:
-	Cursor_(std::shared_ptr<OsFile::Context> context, fs::path const& p)
-	    : context_(std::move(context))
-	    , it_(p) {
+	MappedBuf_(void* addr, std::size_t size)
+	    : addr_(addr)
+	    , size_(size) {
+		auto* const b = static_cast<char*>(addr);
+		this->setg(b, b, b + size);
+	}
+
+	MappedBuf_(MappedBuf_ const& other) = delete;
+	MappedBuf_(MappedBuf_&& other)      = delete;
+
+	~MappedBuf_() override {
+		::munmap(this->addr_, this->size_);
+	}
+
+	MappedBuf_& operator=(MappedBuf_ const& other) = delete;
+	MappedBuf_& operator=(MappedBuf_&& other)      = delete;
+
+   protected:
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+		if((which & std::ios_base::in) == 0) {
+			return pos_type(off_type(-1));
+		}
+
+		off_type base = 0;
+		switch(dir) {
+		case std::ios_base::beg: {
+			break;
+		}
+		case std::ios_base::cur: {
+			base = this->gptr() - this->eback();
+			break;
+		}
+		case std::ios_base::end: {
+			base = static_cast<off_type>(this->size_);
+			break;
+		}
+
+		default: {
+			return pos_type(off_type(-1));
+		}
+		}
+
+		auto const pos = base + off;
+		if(pos < 0 || pos > static_cast<off_type>(this->size_)) {
+			return pos_type(off_type(-1));
+		}
+
+		this->setg(this->eback(), this->eback() + pos, this->egptr());
+		return pos_type(pos);
+	}
+
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+		return this->seekoff(off_type(pos), std::ios_base::beg, which);
+	}
+
+	std::streamsize showmanyc() override {
+		auto const n = this->egptr() - this->gptr();
+		return n > 0 ? n : -1;
+	}
+
+   private:
+	void*       addr_;
+	std::size_t size_;
+};
+
+class MappedStream_: public std::istream {
+   public:
+	MappedStream_(void* addr, std::size_t size)
+	    : std::istream(nullptr)
+	    , buf_(addr, size) {
+		this->rdbuf(&this->buf_);
+	}
+
+   private:
+	MappedBuf_ buf_;
+};
+
+// Returns nullptr if the file cannot or need not be mapped.
+std::shared_ptr<std::istream> map_read_(fs::path const& p) {
+	auto const fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0) {
+		return nullptr;
+	}
+
+	struct stat st { };
+
+	void* addr = MAP_FAILED;
+	if(::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && static_cast<std::uintmax_t>(st.st_size) >= MinMappedReadSize) {
+		addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+
+	// The mapping stays valid after the descriptor is closed.
+	::close(fd);
+	if(addr == MAP_FAILED) {
+		return nullptr;
+	}
+
+	return std::make_shared<MappedStream_>(addr, st.st_size);
+}
+
+// Type from the directory entry if the file system reports it, so listing does not `lstat` each entry.
+fs::file_type type_of_(dirent const& e, int dir_fd, fs::path const& p) {
+#ifdef _DIRENT_HAVE_D_TYPE
+	switch(e.d_type) {
+	case DT_REG:
+		return fs::file_type::regular;
+	case DT_DIR:
+		return fs::file_type::directory;
+	case DT_LNK:
+		return fs::file_type::symlink;
+	case DT_BLK:
+		return fs::file_type::block;
+	case DT_CHR:
+		return fs::file_type::character;
+	case DT_FIFO:
+		return fs::file_type::fifo;
+	case DT_SOCK:
+		return fs::file_type::socket;
+
+	default:
+		break;
+	}
+#endif
+
+	struct stat st { };
+
+	if(::fstatat(dir_fd, e.d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+		if(errno == ENOENT) {
+			// Removed after it is read.
+			return fs::file_type::not_found;
+		}
+		throw_errno_(p);
+	}
+
+	return os_file_type_of(st.st_mode);
+}
+
+#ifdef O_PATH
+constexpr int DirFdFlags = O_PATH | O_DIRECTORY | O_CLOEXEC;
+#else
+constexpr int DirFdFlags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+#endif
+
+}  // namespace
+
+std::shared_ptr<std::istream> map_os_read(fs::path const& p) {
+	if(auto s = map_read_(p); s) {
+		return s;
+	}
+
+	return std::make_shared<std::ifstream>(p, std::ios_base::in);
+}
+
+std::string read_os_file(fs::path const& p) {
+	Fd const in(p, O_RDONLY);
+
+	struct stat st { };
+
+	if(::fstat(in.get(), &st) != 0) {
+		throw fs::filesystem_error("", p, std::error_code(errno, std::generic_category()));
+	}
+	if(S_ISDIR(st.st_mode)) {
+		throw fs::filesystem_error("", p, std::make_error_code(std::errc::is_a_directory));
+	}
+
+	// The size is a hint; the file may be changed while it is read or not report its size at all.
+	auto const read = [&](char* data, std::size_t size) -> std::size_t {
+		while(true) {
+			auto const k = ::read(in.get(), data, size);
+			if(k >= 0) {
+				return k;
+			}
+			if(errno != EINTR) {
+				throw fs::filesystem_error("", p, std::error_code(errno, std::generic_category()));
+			}
+		}
+	};
+
+	std::string s;
+	s.resize(st.st_size);
+
+	std::size_t n = 0;
+	while(true) {
+		if(n < s.size()) {
+			auto const k = read(s.data() + n, s.size() - n);
+			if(k == 0) {
+				break;
+			}
+
+			n += k;
+			continue;
+		}
+
+		// Probes for EOF without growing the string, which is the common case once the hinted size is read.
+		std::array<char, 256> probe;
+
+		auto const k = read(probe.data(), probe.size());
+		if(k == 0) {
+			break;
+		}
+
+		s.resize(std::max(s.size() * 2, n + k));
+		std::copy_n(probe.data(), k, s.data() + n);
+		n += k;
+	}
+
+	s.resize(n);
+	return s;
+}
+
+std::size_t read_os_file_at(fs::path const& p, std::uintmax_t offset, std::span<char> buf) {
+	Fd const in(p, O_RDONLY);
+	return pread_(in.get(), p, buf, offset);
+}
+
+std::shared_ptr<FileHandle> open_os_file(fs::path const& p, std::ios_base::openmode mode, std::shared_ptr<OsStatCache> stat) {
+	auto flags = O_RDONLY;
+	if((mode & std::ios_base::out) == std::ios_base::out) {
+		flags = O_RDWR | O_CREAT;
+		if((mode & std::ios_base::trunc) == std::ios_base::trunc) {
+			flags |= O_TRUNC;
+		}
+	}
+
+	return std::make_shared<Handle_>(p, flags, std::move(stat));
+}
+
+void write_os_file(fs::path const& p, std::string_view data, std::ios_base::openmode mode) {
+	auto const append = (mode & std::ios_base::app) == std::ios_base::app;
+	Fd const  out(p, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC));
+
+	while(!data.empty()) {
+		auto const k = ::write(out.get(), data.data(), data.size());
+		if(k < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			throw fs::filesystem_error("", p, std::error_code(errno, std::generic_category()));
+		}
+
+		data.remove_prefix(k);
+	}
+}
+
+fs::file_type os_file_type_of(unsigned mode) noexcept {
+	switch(mode & S_IFMT) {
+	case S_IFREG:
+		return fs::file_type::regular;
+	case S_IFDIR:
+		return fs::file_type::directory;
+	case S_IFLNK:
+		return fs::file_type::symlink;
+	case S_IFBLK:
+		return fs::file_type::block;
+	case S_IFCHR:
+		return fs::file_type::character;
+	case S_IFIFO:
+		return fs::file_type::fifo;
+	case S_IFSOCK:
+		return fs::file_type::socket;
+
+	default:
+		return fs::file_type::unknown;
+	}
+}
+
+OsStat stat_os_file(fs::path const& p, std::error_code& ec) noexcept {
+	ec.clear();
+
+#ifdef STATX_BASIC_STATS
+	// Only the attributes in `OsStat` are asked, so the kernel may skip the others on some file systems.
+	struct statx stx { };
+
+	if(::statx(AT_FDCWD, p.c_str(), 0, STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME, &stx) == 0) {
+		auto const mtime = std::chrono::seconds(stx.stx_mtime.tv_sec) + std::chrono::nanoseconds(stx.stx_mtime.tv_nsec);
+
+		return OsStat{
+		    .type            = os_file_type_of(stx.stx_mode),
+		    .perms           = static_cast<fs::perms>(stx.stx_mode) & fs::perms::mask,
+		    .size            = static_cast<std::uintmax_t>(stx.stx_size),
+		    .last_write_time = fs::file_time_type::clock::from_sys(std::chrono::sys_time<std::chrono::nanoseconds>(mtime)),
+		};
+	}
+#else
+	struct stat st { };
+
+	if(::stat(p.c_str(), &st) == 0) {
+		return to_os_stat_(st);
+	}
+#endif
+
+	if(errno != ENOENT && errno != ENOTDIR) {
+		ec = std::error_code(errno, std::generic_category());
+	}
+
+	return OsStat{
+	    .type            = ec ? fs::file_type::none : fs::file_type::not_found,
+	    .perms           = fs::perms::unknown,
+	    .size            = static_cast<std::uintmax_t>(-1),
+	    .last_write_time = fs::file_time_type::min(),
+	};
+}
+
+OsStat OsStatCache::get(fs::path const& p) {
+	auto const now = std::chrono::steady_clock::now();
+	if(auto const e = this->entry_.load(std::memory_order_acquire); e && now < e->expires) {
+		return e->stat;
+	}
+
+	std::error_code ec;
+
+	auto const stat = stat_os_file(p, ec);
+	if(ec) {
+		throw fs::filesystem_error("", p, ec);
+	}
+	if(stat.type == fs::file_type::not_found) {
+		// Not cached since the file is likely to be created.
+		return stat;
+	}
+
+	this->entry_.store(std::make_shared<Entry_ const>(Entry_{.stat = stat, .expires = now + Ttl}), std::memory_order_release);
+	return stat;
+}
+
+void OsStatCache::set(OsStat const& stat) {
+	auto const expires = std::chrono::steady_clock::now() + Ttl;
+	this->entry_.store(std::make_shared<Entry_ const>(Entry_{.stat = stat, .expires = expires}), std::memory_order_release);
+}
+
+OsStat OsFile::existing_stat_() const {
+	auto s = this->stat();
+	if(s.type == fs::file_type::not_found) {
+		throw fs::filesystem_error("", this->path_, std::make_error_code(std::errc::no_such_file_or_directory));
+	}
+
+	return s;
+}
+
+std::shared_ptr<MountPoint> OsFile::Context::mount_point_at(fs::path const& p) const {
+	if(this->size_.load(std::memory_order_acquire) == 0) {
+		return nullptr;
+	}
+
+	std::shared_lock const lock(this->mutex_);
+	if(auto const it = this->mount_points_.find(p); it != this->mount_points_.end()) {
+		return it->second;
+	}
+
+	return nullptr;
+}
+
+bool OsFile::Context::has_mount_point_within(fs::path const& p) const {
+	return this->any_mount_point([&](fs::path const& mount_p) {
+		auto const [it, _] = std::mismatch(p.begin(), p.end(), mount_p.begin(), mount_p.end());
+		return it == p.end();
+	});
+}
+
+void OsRegularFile::copy_from(RegularFile const& other) {
+	std::shared_ptr<File const> origin;
+	if(auto const* proxy = dynamic_cast<FileProxy const*>(&other); proxy) {
+		origin = proxy->origin();
+	}
+
+	auto const* f = dynamic_cast<OsRegularFile const*>(origin ? origin.get() : &other);
+	if(f == nullptr) {
+		RegularFile::copy_from(other);
+		return;
+	}
+
+	copy_file_(f->path_, this->path_);
+	this->perms(other.perms(), fs::perm_options::replace);
+}
+
+TempRegularFile::TempRegularFile()
+    : OsRegularFile("") {
+#ifdef O_TMPFILE
+	// Named by a link to the unnamed file, and the descriptor is closed then
+	// so live files do not hold descriptors of the process.
+	if(Fd const fd(open_unnamed_temp_()); fd) {
+		auto const fd_p = "/proc/self/fd/" + std::to_string(fd.get());
+
+		auto linked = true;
+
+		auto named = make_temp_([&](fs::path const& p, std::error_code& ec) {
+			if(::linkat(AT_FDCWD, fd_p.c_str(), AT_FDCWD, p.c_str(), AT_SYMLINK_FOLLOW) == 0) {
+				return true;
+			}
+			if(errno == EEXIST || errno == ENOENT) {
+				ec = std::error_code(errno, std::generic_category());
+				return false;
+			}
+
+			// e.g. EPERM if `/proc` is restricted; a named file is made instead.
+			linked = false;
+			return true;
+		});
+		if(linked) {
+			this->path_ = std::move(named);
+			return;
+		}
+	}
+#endif
+
+	this->path_ = make_temp_([](fs::path const& p, std::error_code& ec) {
+		auto const fd = ::open(p.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+		if(fd < 0) {
+			ec = std::error_code(errno, std::generic_category());
+			return false;
+		}
+
+		::close(fd);
+		return true;
+	});
+}
+
+TempRegularFile::~TempRegularFile() {
+	if(!is_in_temp_directory_(this->path_)) {
+		return;
+	}
+
+	fs::remove(this->path_);
+}
+
+class OsDirectory::DirFd_ {
+   public:
+	DirFd_(std::shared_ptr<DirFd_> parent, fs::path p)
+	    : parent_(std::move(parent))
+	    , path_(std::move(p)) { }
+
+	DirFd_(DirFd_ const& other) = delete;
+	DirFd_(DirFd_&& other)      = delete;
+
+	~DirFd_() {
+		if(auto const fd = this->fd_.load(std::memory_order_relaxed); fd >= 0) {
+			::close(fd);
+		}
+		for(auto const fd: this->retired_) {
+			::close(fd);
+		}
+	}
+
+	DirFd_& operator=(DirFd_ const& other) = delete;
+	DirFd_& operator=(DirFd_&& other)      = delete;
+
+	int get() {
+		if(auto const fd = this->fd_.load(std::memory_order_acquire); fd >= 0) {
+			return fd;
+		}
+
+		std::lock_guard const lock(this->mutex_);
+		if(auto const fd = this->fd_.load(std::memory_order_acquire); fd >= 0) {
+			// Opened by another thread.
+			return fd;
+		}
+
+		// Opened relative to the parent so only the last component is resolved.
+		auto const fd = this->parent_
+		                    ? ::openat(this->parent_->get(), this->path_.filename().c_str(), DirFdFlags | O_NOFOLLOW)
+		                    : ::open(this->path_.c_str(), DirFdFlags);
+		if(fd < 0) {
+			throw_errno_(this->path_);
+		}
+
+		this->fd_.store(fd, std::memory_order_release);
+		return fd;
+	}
+
+	// Whether the directory the descriptor is on is removed; it costs a `fstat` but no lock nor path resolution.
+	// `errno` is kept.
+	[[nodiscard]] bool removed() const noexcept {
+		auto const fd = this->fd_.load(std::memory_order_acquire);
+		if(fd < 0) {
+			return false;
+		}
+
+		auto const saved = errno;
+
+		struct stat st { };
+
+		auto const ok = ::fstat(fd, &st) == 0 && st.st_nlink == 0;
+		errno         = saved;
+		return ok;
+	}
+
+	// The descriptor stays on the directory it was opened on, so a directory removed and made again
+	// at the same path, e.g. by another process, would not be seen through it.
+	// Reopens the descriptor if the path is now another directory and returns whether it did.
+	// `errno` is kept if it returns false.
+	bool revalidate() {
+		auto const saved = errno;
+
+		std::lock_guard const lock(this->mutex_);
+
+		auto const fd = this->fd_.load(std::memory_order_acquire);
+		if(fd < 0) {
+			errno = saved;
+			return false;
+		}
+
+		struct stat held { };
+		struct stat now { };
+
+		if(::fstat(fd, &held) != 0 || ::stat(this->path_.c_str(), &now) != 0 || (held.st_dev == now.st_dev && held.st_ino == now.st_ino)) {
+			errno = saved;
+			return false;
+		}
+
+		auto const next = ::open(this->path_.c_str(), DirFdFlags);
+		if(next < 0) {
+			errno = saved;
+			return false;
+		}
+
+		// Other threads may still be using the previous one.
+		this->retired_.push_back(fd);
+		this->fd_.store(next, std::memory_order_release);
+		return true;
+	}
+
+   private:
+	std::shared_ptr<DirFd_> parent_;
+	fs::path                path_;
+
+	std::mutex       mutex_;
+	std::atomic<int> fd_ = -1;
+
+	std::vector<int> retired_;
+};
+
+class OsDirectory::Cursor_: public Directory::Cursor {
+   public:
+	Cursor_(OsDirectory const& dir)
+	    : dir_(dir)
+	    , stream_(nullptr, &::closedir) {
+		// A removed directory can still be opened through its descriptor, and lists nothing.
+		this->dir_.fd_->revalidate();
+
+		auto const fd = ::openat(this->dir_.dir_fd_(), ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if(fd < 0) {
+			throw_errno_(this->dir_.path_);
+		}
+
+		this->stream_.reset(::fdopendir(fd));
+		if(!this->stream_) {
+			::close(fd);
+			throw_errno_(this->dir_.path_);
+		}
+
 		this->refresh();
 	}
 
@@ -65,137 +878,208 @@ class Cursor_: public Directory::Cursor {
 			return;
 		}
 
-		this->it_++;
 		this->refresh();
 	}
 
 	[[nodiscard]] bool at_end() const override {
-		return this->it_ == this->end_;
+		return !this->stream_;
 	}
 
+	// Reads the next entry.
 	void refresh() {
-		if(Cursor_::at_end()) {
-			this->name_ = "";
-			this->file_ = nullptr;
-		} else {
-			this->name_ = this->it_->path().filename();
-			this->file_ = make_file_(this->it_->symlink_status().type(), this->context_, this->it_->path());
+		errno = 0;
+		while(auto const* e = ::readdir(this->stream_.get())) {
+			std::string_view const name = e->d_name;
+			if(name == "." || name == "..") {
+				continue;
+			}
+
+			this->name_ = name;
+
+			auto const p = this->dir_.path_ / this->name_;
+			if(auto m = this->dir_.context_->mount_point_at(p); m) {
+				this->file_ = std::move(m);
+				return;
+			}
+
+			auto const type = type_of_(*e, ::dirfd(this->stream_.get()), p);
+			if(type == fs::file_type::not_found) {
+				errno = 0;
+				continue;
+			}
+
+			this->file_ = this->dir_.make_child_(type, this->name_);
+			return;
+		}
+		if(errno != 0) {
+			throw_errno_(this->dir_.path_);
 		}
+
+		this->name_ = "";
+		this->file_ = nullptr;
+		this->stream_.reset();
 	}
 
    private:
-	std::shared_ptr<OsFile::Context> context_;
+	OsDirectory dir_;
 
-	fs::directory_iterator it_;
-	fs::directory_iterator end_;
+	std::unique_ptr<DIR, int (*)(DIR*)> stream_;
 
 	std::string           name_;
 	std::shared_ptr<File> file_;
 };
 
-}  // namespace
+OsDirectory::OsDirectory(std::shared_ptr<Context> context, fs::path p)
+    : OsFile(std::move(context), std::move(p))
+    , fd_(std::make_shared<DirFd_>(nullptr, this->path_)) { }
 
-TempRegularFile::TempRegularFile()
-    : OsRegularFile("") {
-	auto const d = temp_directory_();
+OsDirectory::OsDirectory(fs::path p)
+    : OsFile(std::move(p))
+    , fd_(std::make_shared<DirFd_>(nullptr, this->path_)) { }
 
-	this->path_ = d / "foo";
-	do {
-		fs::create_directories(d);
-		this->path_.replace_filename(random_filename_());
+void OsDirectory::move_to(fs::path const& p) {
+	OsFile::move_to(p);
+	this->fd_ = std::make_shared<DirFd_>(nullptr, this->path_);
+}
 
-		auto* f = std::fopen(this->path_.c_str(), "wx");
-		if(f != nullptr) {
-			std::fclose(f);
-			break;
-		}
-	} while(true);
+int OsDirectory::dir_fd_() const {
+	return this->fd_->get();
 }
 
-TempRegularFile::~TempRegularFile() {
-	if(!is_in_temp_directory_(this->path_)) {
-		return;
+template<typename F>
+int OsDirectory::at_(F&& f) const {
+	auto const r = f(this->dir_fd_());
+	// A name that does not exist is the common case, so the path is resolved again only if the directory is removed.
+	if(r >= 0 || errno != ENOENT || !this->fd_->removed() || !this->fd_->revalidate()) {
+		return r;
 	}
 
-	fs::remove(this->path_);
+	return f(this->dir_fd_());
+}
+
+std::shared_ptr<File> OsDirectory::make_child_(fs::file_type type, std::string const& name) const {
+	auto p = this->path_ / name;
+	if(type != fs::file_type::directory) {
+		return make_file_(type, this->context_, p);
+	}
+
+	auto d = std::make_shared<OsDirectory>(this->context_, std::move(p));
+	d->fd_ = std::make_shared<DirFd_>(this->fd_, d->path_);
+	return d;
+}
+
+bool OsDirectory::contains(std::string const& name) const {
+	if(this->context_->mount_point_at(this->path_ / name)) {
+		return true;
+	}
+
+	struct stat st { };
+
+	return this->at_([&](int fd) { return ::fstatat(fd, name.c_str(), &st, 0); }) == 0;
 }
 
 bool OsDirectory::exists(std::filesystem::path const& p) const {
-	return this->context_->mount_points.contains(p) || std::filesystem::exists(p);
+	return this->context_->mount_point_at(p) || std::filesystem::exists(p);
 }
 
 std::shared_ptr<File> OsDirectory::next(std::string const& name) const {
 	auto const next_p = this->path_ / name;
-	if(auto it = this->context_->mount_points.find(next_p); it != this->context_->mount_points.end()) {
-		return it->second;
+	if(auto m = this->context_->mount_point_at(next_p); m) {
+		return m;
 	}
 
-	auto const status = fs::symlink_status(next_p);
-	if(not fs::exists(status)) {
-		return nullptr;
+	struct stat st { };
+
+	if(this->at_([&](int fd) { return ::fstatat(fd, name.c_str(), &st, AT_SYMLINK_NOFOLLOW); }) != 0) {
+		if(errno == ENOENT || errno == ENOTDIR) {
+			return nullptr;
+		}
+		throw_errno_(next_p);
 	}
 
-	return make_file_(status.type(), this->context_, next_p);
+	auto const stat = to_os_stat_(st);
+	auto       f    = this->make_child_(stat.type, name);
+	if(stat.type != fs::file_type::symlink) {
+		// `lstat` of a file that is not a symbolic link is what `stat` gives.
+		if(auto* os_f = dynamic_cast<OsFile*>(f.get()); os_f != nullptr) {
+			os_f->seed(stat);
+		}
+	}
+
+	return f;
 }
 
 std::pair<std::shared_ptr<RegularFile>, bool> OsDirectory::emplace_regular_file(std::string const& name) {
+	OsStatCache::Invalidation const invalidation(this->stat_.get());
+
 	auto const next_p = this->path_ / name;
-	if(auto const m = this->context_->mount_points.find(next_p); m != this->context_->mount_points.end()) {
-		return std::make_pair(std::dynamic_pointer_cast<RegularFile>(m->second), false);
+	if(auto m = this->context_->mount_point_at(next_p); m) {
+		return std::make_pair(std::dynamic_pointer_cast<RegularFile>(std::move(m)), false);
 	}
 
-	auto*      f  = std::fopen(next_p.c_str(), "wx");
-	auto const ok = f != nullptr;
+	auto const fd = this->at_([&](int dir_fd) { return ::openat(dir_fd, name.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666); });
+	auto const ok = fd >= 0;
 	if(ok) {
-		std::fclose(f);
-	} else if(not fs::is_regular_file(next_p)) {
-		return std::make_pair(nullptr, false);
+		::close(fd);
+		this->context_->changes.notify_inserted();
+	} else {
+		struct stat st { };
+
+		if(::fstatat(this->dir_fd_(), name.c_str(), &st, 0) != 0 || !S_ISREG(st.st_mode)) {
+			return std::make_pair(nullptr, false);
+		}
 	}
 
 	return std::make_pair(std::make_shared<OsRegularFile>(this->context_, next_p), ok);
 }
 
 std::pair<std::shared_ptr<Directory>, bool> OsDirectory::emplace_directory(std::string const& name) {
+	OsStatCache::Invalidation const invalidation(this->stat_.get());
+
 	auto const next_p = this->path_ / name;
-	if(auto const m = this->context_->mount_points.find(next_p); m != this->context_->mount_points.end()) {
-		return std::make_pair(std::dynamic_pointer_cast<Directory>(m->second), false);
+	if(auto m = this->context_->mount_point_at(next_p); m) {
+		return std::make_pair(std::dynamic_pointer_cast<Directory>(std::move(m)), false);
 	}
 
-	try {
-		// No exception is thrown if next_p is an existing directory and false is returned.
-		auto const ok = fs::create_directory(next_p);
-		if(!ok && fs::is_symlink(next_p)) {
-			// If next_p is a symbolic link that linked to directory, no exception is thrown.
-			return std::make_pair(nullptr, false);
+	auto const ok = this->at_([&](int fd) { return ::mkdirat(fd, name.c_str(), 0777); }) == 0;
+	if(ok) {
+		this->context_->changes.notify_inserted();
+	} else {
+		if(errno != EEXIST) {
+			throw_errno_(next_p);
 		}
 
-		return std::make_pair(std::make_shared<OsDirectory>(this->context_, next_p), ok);
-	} catch(fs::filesystem_error const& error) {
-		if(error.code() != std::errc::file_exists) {
-			throw error;
-		}
+		// A symbolic link to a directory is not a directory here.
+		struct stat st { };
 
-		// next_p exists but not a directory.
-		return std::make_pair(nullptr, false);
+		if(::fstatat(this->dir_fd_(), name.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISDIR(st.st_mode)) {
+			return std::make_pair(nullptr, false);
+		}
 	}
+
+	return std::make_pair(std::dynamic_pointer_cast<Directory>(this->make_child_(fs::file_type::directory, name)), ok);
 }
 
 std::pair<std::shared_ptr<Symlink>, bool> OsDirectory::emplace_symlink(std::string const& name, std::filesystem::path target) {
+	OsStatCache::Invalidation const invalidation(this->stat_.get());
+
 	auto const next_p = this->path_ / name;
-	if(auto const m = this->context_->mount_points.find(next_p); m != this->context_->mount_points.end()) {
+	if(this->context_->mount_point_at(next_p)) {
 		// Symbolic link cannot be mounted.
 		return std::make_pair(nullptr, false);
 	}
 
-	auto ok = false;
-	try {
-		fs::create_symlink(target, next_p);
-		ok = true;
-	} catch(std::filesystem::filesystem_error const& error) {
-		if(error.code() != std::errc::file_exists) {
-			throw error;
+	auto const ok = this->at_([&](int fd) { return ::symlinkat(target.c_str(), fd, name.c_str()); }) == 0;
+	if(ok) {
+		this->context_->changes.notify_inserted();
+	} else {
+		if(errno != EEXIST) {
+			throw_errno_(next_p);
 		}
-		if(not fs::is_symlink(next_p)) {
+
+		struct stat st { };
+
+		if(::fstatat(this->dir_fd_(), name.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISLNK(st.st_mode)) {
 			return std::make_pair(nullptr, false);
 		}
 	}
@@ -204,6 +1088,8 @@ std::pair<std::shared_ptr<Symlink>, bool> OsDirectory::emplace_symlink(std::stri
 }
 
 bool OsDirectory::link(std::string const& name, std::shared_ptr<File> file) {
+	OsStatCache::Invalidation const invalidation(this->stat_.get());
+
 	if(auto f = std::dynamic_pointer_cast<VFile>(std::move(file)); f) {
 		throw fs::filesystem_error("cannot create link to different type of filesystem", std::make_error_code(std::errc::cross_device_link));
 	}
@@ -211,49 +1097,89 @@ bool OsDirectory::link(std::string const& name, std::shared_ptr<File> file) {
 	auto f = std::dynamic_pointer_cast<OsFile>(std::move(file));
 	assert(nullptr != f);
 
-	try {
-		fs::create_hard_link(f->path(), this->path_ / name);
-		return true;
-	} catch(fs::filesystem_error const& error) {
-		if(error.code() != std::errc::file_exists) {
-			throw error;
+	if(this->at_([&](int fd) { return ::linkat(AT_FDCWD, f->path().c_str(), fd, name.c_str(), 0); }) != 0) {
+		if(errno != EEXIST) {
+			throw fs::filesystem_error("", f->path(), this->path_ / name, std::error_code(errno, std::generic_category()));
 		}
 
 		return false;
 	}
+
+	this->context_->changes.notify_inserted();
+	return true;
 }
 
 std::uintmax_t OsDirectory::erase(std::string const& name) {
+	OsStatCache::Invalidation const invalidation(this->stat_.get());
+
 	auto const target = this->path_ / name;
-	for(auto const [p, _]: this->context_->mount_points) {
+	fs::path busy;
+
+	auto const is_busy = this->context_->any_mount_point([&](fs::path const& p) {
 		auto const entry = *target.lexically_relative(p).begin();
 		if(entry == "." || entry == "..") {
-			throw fs::filesystem_error("", p, std::make_error_code(std::errc::device_or_resource_busy));
+			busy = p;
+			return true;
+		}
+		return false;
+	});
+	if(is_busy) {
+		throw fs::filesystem_error("", busy, std::make_error_code(std::errc::device_or_resource_busy));
+	}
+
+	struct stat st { };
+
+	if(this->at_([&](int fd) { return ::fstatat(fd, name.c_str(), &st, AT_SYMLINK_NOFOLLOW); }) != 0) {
+		if(errno == ENOENT || errno == ENOTDIR) {
+			return 0;
 		}
+		throw_errno_(target);
 	}
 
-	return fs::remove_all(target);
+	std::uintmax_t cnt = 1;
+	if(S_ISDIR(st.st_mode)) {
+		cnt = fs::remove_all(target);
+	} else if(::unlinkat(this->dir_fd_(), name.c_str(), 0) != 0) {
+		throw_errno_(target);
+	}
+	if(cnt > 0) {
+		this->context_->changes.notify_removed();
+	}
+
+	return cnt;
 }
 
 std::uintmax_t OsDirectory::clear() {
+	OsStatCache::Invalidation const invalidation(this->stat_.get());
+
 	std::uintmax_t cnt = 0;
 	for(auto const& dir_entry: fs::directory_iterator{this->path_}) {
 		cnt += fs::remove_all(dir_entry);
 	}
+	if(cnt > 0) {
+		this->context_->changes.notify_removed();
+	}
 
 	return cnt;
 }
 
 std::shared_ptr<Directory::Cursor> OsDirectory::cursor() const {
-	return std::make_shared<Cursor_>(this->context_, this->path_);
+	return std::make_shared<Cursor_>(*this);
 }
 
 TempDirectory::TempDirectory()
     : OsDirectory("") {
-	this->path_ = temp_directory_() / "foo";
-	do {
-		this->path_.replace_filename(random_filename_());
-	} while(!fs::create_directories(this->path_));
+	this->path_ = make_temp_([](fs::path const& p, std::error_code& ec) {
+		if(fs::create_directory(p, ec)) {
+			return true;
+		}
+		if(!ec) {
+			ec = std::make_error_code(std::errc::file_exists);
+		}
+
+		return false;
+	});
+	this->fd_ = std::make_shared<DirFd_>(nullptr, this->path_);
 }
 
 TempDirectory::~TempDirectory() {
@@ -266,21 +1192,10 @@ TempDirectory::~TempDirectory() {
 
 TempSymlink::TempSymlink(fs::path const& target)
     : OsSymlink("") {
-	auto const d = temp_directory_();
-
-	this->path_ = d / "foo";
-	do {
-		fs::create_directories(d);
-		this->path_.replace_filename(random_filename_());
-
-		try {
-			fs::create_symlink(target, this->path_);
-		} catch(std::filesystem::filesystem_error const& error) {
-			if(error.code() != std::errc::file_exists) {
-				throw error;
-			}
-		}
-	} while(true);
+	this->path_ = make_temp_([&target](fs::path const& p, std::error_code& ec) {
+		fs::create_symlink(target, p, ec);
+		return !ec;
+	});
 }
 
 TempSymlink::~TempSymlink() {
@@ -2,11 +2,34 @@
 #include "vfs/fs.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
 #include <cstddef>
 #include <filesystem>
+#include <functional>
+#include <ios>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#if __has_include(<linux/openat2.h>)
+#include <linux/openat2.h>
+#endif
+#endif
 
 #include "vfs/impl/file.hpp"
+#include "vfs/impl/io_engine.hpp"
 #include "vfs/impl/os_file.hpp"
 #include "vfs/impl/utils.hpp"
 #include "vfs/impl/vfs.hpp"
@@ -141,6 +164,148 @@ std::shared_ptr<File const> StdFs::file_at_followed(fs::path const& p) const {
 	}
 }
 
+FileStatuses StdFs::status_many(std::span<fs::path const> ps) const {
+	// Each thread takes this many paths at a time; smaller batches are done on the caller's thread.
+	constexpr std::size_t ChunkSize = 256;
+
+	FileStatuses rst;
+	rst.resize(ps.size());
+
+	std::atomic<std::size_t> next = 0;
+
+	auto const work = [&] {
+		while(true) {
+			auto const first = next.fetch_add(ChunkSize, std::memory_order_relaxed);
+			if(first >= ps.size()) {
+				return;
+			}
+
+			auto const last = std::min(first + ChunkSize, ps.size());
+			for(auto i = first; i < last; ++i) {
+				auto& ec = rst.errors[i];
+
+				OsStat s{};
+				try {
+					s = stat_os_file(this->os_path_of(ps[i]), ec);
+				} catch(fs::filesystem_error const& err) {
+					ec = err.code();
+				}
+				if(ec) {
+					continue;
+				}
+
+				rst.types[i] = s.type;
+				if(s.type == fs::file_type::not_found) {
+					continue;
+				}
+
+				rst.perms[i]            = s.perms;
+				rst.last_write_times[i] = s.last_write_time;
+				if(s.type == fs::file_type::regular) {
+					rst.sizes[i] = s.size;
+				}
+			}
+		}
+	};
+
+	// Helpers run on the pool of the I/O engine rather than threads made for each call.
+	// A helper that starts after the caller is done returns without touching the paths,
+	// so the caller never waits for the pool, e.g. if it is called from a callback on the pool.
+	struct Helpers {
+		std::mutex              mutex;
+		std::condition_variable cv;
+
+		std::size_t running = 0;
+		bool        closed  = false;
+	};
+
+	auto const helpers = std::make_shared<Helpers>();
+
+	auto const n = std::min<std::size_t>(std::max(1U, std::thread::hardware_concurrency()), (ps.size() + ChunkSize - 1) / ChunkSize);
+	for(std::size_t i = 1; i < n; ++i) {
+		IoEngine::instance().submit([helpers, &work] {
+			{
+				std::lock_guard const lock(helpers->mutex);
+				if(helpers->closed) {
+					return;
+				}
+				++helpers->running;
+			}
+
+			work();
+
+			{
+				std::lock_guard const lock(helpers->mutex);
+				--helpers->running;
+			}
+			helpers->cv.notify_one();
+		});
+	}
+
+	work();
+
+	std::unique_lock lock(helpers->mutex);
+	helpers->closed = true;
+	helpers->cv.wait(lock, [&] { return helpers->running == 0; });
+
+	return rst;
+}
+
+namespace {
+
+// Runs `job` on the I/O engine while keeping `fs` alive.
+template<typename F>
+void submit_io_(Fs const& fs, F job) {
+	auto self = fs.weak_from_this().lock();
+	if(!self) {
+		// Nothing would keep `fs` alive until the job runs.
+		job();
+		return;
+	}
+
+	IoEngine::instance().submit([self = std::move(self), job = std::move(job)]() mutable { job(); });
+}
+
+// Calls `f` with the OS path of `p`, or reports the failure to `callback` on the engine as a failed I/O would be.
+template<typename F, typename... Args>
+void with_os_path_(StdFs const& fs, fs::path const& p, std::function<void(std::error_code, Args...)> callback, F const& f) {
+	std::error_code ec;
+
+	auto os_p = handle_error([&] { return fs.os_path_of(p); }, ec);
+	if(ec) {
+		IoEngine::instance().submit([ec, callback = std::move(callback)] { callback(ec, Args{}...); });
+		return;
+	}
+
+	f(std::move(os_p), std::move(callback));
+}
+
+}  // namespace
+
+void StdFs::async_read_file(fs::path const& filename, std::function<void(std::error_code, std::string)> callback) const {
+	with_os_path_(*this, filename, std::move(callback), [](fs::path p, auto callback) {
+		IoEngine::instance().read_file(std::move(p), std::move(callback));
+	});
+}
+
+void StdFs::async_write_file(fs::path const& filename, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) {
+	with_os_path_(*this, filename, std::move(callback), [&](fs::path p, auto callback) {
+		IoEngine::instance().write_file(std::move(p), std::move(data), mode, std::move(callback));
+	});
+}
+
+void StdFs::async_status(fs::path const& p, std::function<void(std::error_code, fs::file_status)> callback) const {
+	with_os_path_(*this, p, std::move(callback), [](fs::path os_p, auto callback) {
+		IoEngine::instance().status(std::move(os_p), std::move(callback));
+	});
+}
+
+void StdFs::async_copy(fs::path const& src, fs::path const& dst, fs::copy_options opts, std::function<void(std::error_code)> callback) {
+	submit_io_(*this, [this, src, dst, opts, callback = std::move(callback)]() mutable {
+		this->FsBase::async_copy(src, dst, opts, std::move(callback));
+	});
+}
+
 std::shared_ptr<Fs::Cursor> StdFs::cursor_(fs::path const& p, fs::directory_options opts) const {
 	return std::make_shared<StdFs::Cursor_<Fs::Cursor, fs::directory_iterator>>(*this, p, opts);
 }
@@ -149,19 +314,92 @@ std::shared_ptr<Fs::RecursiveCursor> StdFs::recursive_cursor_(fs::path const& p,
 	return std::make_shared<StdFs::RecursiveCursor_>(*this, p, opts);
 }
 
+Fd ChRootedStdFs::open_base_(fs::path const& base) {
+	return Fd(::open(base.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+}
+
+bool ChRootedStdFs::is_beneath_(fs::path const& r) const {
+#if defined(__linux__) && defined(SYS_openat2) && defined(RESOLVE_BENEATH)
+	static std::atomic<bool> supported = true;
+	if(!this->base_fd_ || !supported.load(std::memory_order_relaxed)) {
+		return false;
+	}
+
+	auto const base_fd = this->base_fd_.get();
+
+	open_how how{};
+	how.flags   = O_PATH | O_CLOEXEC;
+	how.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS;
+
+	// Trims nonexistent components from the end, which are normalized lexically by `weakly_canonical`.
+	auto prefix = r;
+	while(true) {
+		auto const target = prefix.empty() ? fs::path(".") : prefix;
+
+		auto const fd = static_cast<int>(::syscall(SYS_openat2, base_fd, target.c_str(), &how, sizeof(how)));
+		if(fd >= 0) {
+			if(prefix.native().size() == r.native().size()) {
+				::close(fd);
+				return true;
+			}
+
+			// The rest must be plain names that do not exist; a dangling symbolic link could point outside.
+			auto const rest  = r.lexically_relative(prefix);
+			auto const first = *rest.begin();
+
+			struct stat st { };
+
+			auto const exists = ::fstatat(fd, first.c_str(), &st, AT_SYMLINK_NOFOLLOW) == 0;
+			::close(fd);
+
+			return !exists && std::none_of(rest.begin(), rest.end(), [](auto const& entry) { return entry == ".."; });
+		}
+
+		switch(errno) {
+		case ENOSYS:
+		case EPERM: {
+			// Not supported by the kernel or filtered by seccomp.
+			supported.store(false, std::memory_order_relaxed);
+			return false;
+		}
+		case ENOENT: {
+			break;
+		}
+
+		default: {
+			// Escaping the base (`EXDEV`) or anything that the canonicalization has to decide.
+			return false;
+		}
+		}
+
+		if(prefix.empty()) {
+			return false;
+		}
+		prefix = prefix.parent_path();
+	}
+#else
+	return false;
+#endif
+}
+
 fs::path ChRootedStdFs::os_path_of(fs::path const& p) const {
-	auto const a = this->base_ / (this->cwd_ / p).relative_path();
+	auto const r = (this->cwd_ / p).relative_path();
+	auto const a = this->base_ / r;
+	if(!r.empty() && this->is_beneath_(r)) {
+		return a;
+	}
+
 	auto const c = fs::weakly_canonical(a);
-	auto const r = c.lexically_relative(this->base_);
-	if(r.empty() || (*r.begin() == ".")) {
+	auto const d = c.lexically_relative(this->base_);
+	if(d.empty() || (*d.begin() == ".")) {
 		return this->base_;
 	}
-	if(*r.begin() == "..") {
-		auto it = std::find_if(r.begin(), r.end(), [](auto entry) { return entry != ".."; });
-		if(it == r.end()) {
+	if(*d.begin() == "..") {
+		auto it = std::find_if(d.begin(), d.end(), [](auto entry) { return entry != ".."; });
+		if(it == d.end()) {
 			return this->base_;
 		}
-		return this->base_ / acc_paths(it, r.end());
+		return this->base_ / acc_paths(it, d.end());
 	}
 
 	return a;
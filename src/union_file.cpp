@@ -5,12 +5,18 @@
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
+#include "vfs/impl/lookup_cache.hpp"
+
 namespace fs = std::filesystem;
 
 namespace vfs {
@@ -26,7 +32,7 @@ std::uintmax_t count_files_(UnionDirectory::Context& context, File const& file)
 
 	std::uintmax_t cnt = 1;
 	for(auto const& [name, f]: *d) {
-		if(context.hidden.contains(name)) {
+		if(context.is_hidden(name)) {
 			continue;
 		}
 
@@ -86,6 +92,10 @@ class RegularFileOnLower_: public TypedFileProxy<RegularFile> {
 	    , name_(std::move(name))
 	    , anchor_(std::move(anchor)) { }
 
+	void copy_from(RegularFile const& other) override {
+		this->pull_(std::ios_base::trunc)->copy_from(other);
+	}
+
 	[[nodiscard]] std::uintmax_t size() const override {
 		return this->origin_->size();
 	}
@@ -102,6 +112,33 @@ class RegularFileOnLower_: public TypedFileProxy<RegularFile> {
 		return this->pull_(mode)->open_write(mode);
 	}
 
+	[[nodiscard]] std::shared_ptr<std::istream> map_read() const override {
+		return this->origin_->map_read();
+	}
+
+	[[nodiscard]] std::string read_all() const override {
+		return this->origin_->read_all();
+	}
+
+	[[nodiscard]] std::size_t read_at(std::uintmax_t offset, std::span<char> buf) const override {
+		return this->origin_->read_at(offset, buf);
+	}
+
+	void write_all(std::string_view data, std::ios_base::openmode mode) override {
+		this->pull_(mode)->write_all(data, mode);
+	}
+
+	[[nodiscard]] std::shared_ptr<FileHandle> open_handle(std::ios_base::openmode mode) override {
+		using ios = std::ios_base;
+		if((mode & ios::out) == 0) {
+			return this->origin_->open_handle(mode);
+		}
+
+		// Writes at offsets keep the rest of contents unless truncated.
+		auto const pull_mode = (mode & ios::trunc) == ios::trunc ? ios::trunc : ios::app;
+		return this->pull_(pull_mode)->open_handle(mode);
+	}
+
    private:
 	std::shared_ptr<RegularFile>& pull_(std::ios_base::openmode mode) {
 		if(!this->anchor_.has_value()) {
@@ -178,7 +215,7 @@ class SupBranch_
 	bool unlink(std::string const& name) override {
 		auto const ok = this->origin_->unlink(name);
 		if(ok) {
-			this->context_->hidden.insert(name);
+			this->context_->hide(name);
 		}
 
 		return ok;
@@ -187,7 +224,7 @@ class SupBranch_
 	std::uintmax_t erase(std::string const& name) override {
 		auto const cnt = this->origin_->erase(name);
 		if(cnt > 0) {
-			this->context_->hidden.insert(name);
+			this->context_->hide(name);
 		}
 
 		return cnt;
@@ -195,7 +232,7 @@ class SupBranch_
 
 	std::uintmax_t clear() override {
 		for(auto const& [name, _]: *this->origin_) {
-			this->context_->hidden.insert(name);
+			this->context_->hide(name);
 		}
 
 		return this->origin_->clear();
@@ -236,7 +273,7 @@ class SubBranch_
 		}
 
 		for(auto const& [name, _]: *this->origin_) {
-			if(this->context_->hidden.contains(name)) {
+			if(this->context_->is_hidden(name)) {
 				continue;
 			}
 
@@ -247,7 +284,7 @@ class SubBranch_
 	}
 
 	[[nodiscard]] bool contains(std::string const& name) const override {
-		if(this->context_->hidden.contains(name)) {
+		if(this->context_->is_hidden(name)) {
 			return false;
 		}
 
@@ -255,7 +292,7 @@ class SubBranch_
 	}
 
 	[[nodiscard]] std::shared_ptr<File> next(std::string const& name) const override {
-		if(this->context_->hidden.contains(name)) {
+		if(this->context_->is_hidden(name)) {
 			return nullptr;
 		}
 
@@ -281,7 +318,9 @@ class SubBranch_
 			return std::make_pair(std::dynamic_pointer_cast<RegularFile>(std::move(next)), false);
 		}
 
-		return this->anchor_.pull()->emplace_regular_file(name);
+		auto it = this->anchor_.pull()->emplace_regular_file(name);
+		this->context_->changes.notify_inserted();
+		return it;
 	}
 
 	std::pair<std::shared_ptr<Directory>, bool> emplace_directory(std::string const& name) override {
@@ -289,7 +328,9 @@ class SubBranch_
 			return std::make_pair(std::dynamic_pointer_cast<Directory>(std::move(next)), false);
 		}
 
-		return this->anchor_.pull()->emplace_directory(name);
+		auto it = this->anchor_.pull()->emplace_directory(name);
+		this->context_->changes.notify_inserted();
+		return it;
 	}
 
 	std::pair<std::shared_ptr<Symlink>, bool> emplace_symlink(std::string const& name, std::filesystem::path target) override {
@@ -297,28 +338,35 @@ class SubBranch_
 			return std::make_pair(std::dynamic_pointer_cast<Symlink>(std::move(next)), false);
 		}
 
-		return this->anchor_.pull()->emplace_symlink(name, target);
+		auto it = this->anchor_.pull()->emplace_symlink(name, target);
+		this->context_->changes.notify_inserted();
+		return it;
 	}
 
 	bool unlink(std::string const& name) override {
-		if(this->context_->hidden.contains(name)) {
+		if(this->context_->is_hidden(name)) {
 			return false;
 		}
 		if(!this->origin_->contains(name)) {
 			return false;
 		}
 
-		auto const [_, ok] = this->context_->hidden.insert(name);
-		assert(ok);
+		if(!this->context_->hide(name)) {
+			// Hidden by another thread.
+			return false;
+		}
+
+		this->context_->changes.notify_removed();
 		return true;
 	}
 
 	void mount(std::string const& name, std::shared_ptr<File> file) override {
 		this->anchor_.pull()->mount(name, std::move(file));
+		this->context_->changes.notify_removed();
 	}
 
 	std::uintmax_t erase(std::string const& name) override {
-		if(this->context_->hidden.contains(name)) {
+		if(this->context_->is_hidden(name)) {
 			return 0;
 		}
 
@@ -327,8 +375,11 @@ class SubBranch_
 			return 0;
 		}
 
-		auto const [_, ok] = this->context_->hidden.insert(name);
-		assert(ok);
+		if(!this->context_->hide(name)) {
+			return 0;
+		}
+
+		this->context_->changes.notify_removed();
 
 		auto const ctx = this->context_->at(name);
 		auto const cnt = count_files_(*ctx, *next_f);
@@ -338,7 +389,7 @@ class SubBranch_
 	std::uintmax_t clear() override {
 		std::uintmax_t cnt = 0;
 		for(auto const& [name, next_f]: *this->origin_) {
-			auto [_, ok] = this->context_->hidden.insert(name);
+			auto const ok = this->context_->hide(name);
 			if(!ok) {
 				continue;
 			}
@@ -346,6 +397,9 @@ class SubBranch_
 			auto const ctx = this->context_->at(name);
 			cnt += count_files_(*ctx, *next_f);
 		}
+		if(cnt > 0) {
+			this->context_->changes.notify_removed();
+		}
 
 		return cnt;
 	}
@@ -353,7 +407,7 @@ class SubBranch_
 	[[nodiscard]] std::shared_ptr<Cursor> cursor() const override {
 		std::unordered_map<std::string, std::shared_ptr<File>> files;
 		for(auto it: *this->origin_) {
-			if(this->context_->hidden.contains(it.first)) {
+			if(this->context_->is_hidden(it.first)) {
 				continue;
 			}
 
@@ -363,6 +417,12 @@ class SubBranch_
 		return std::make_shared<Directory::StaticCursor>(std::move(files));
 	}
 
+	void watch_changes(ChangeWatch& watch) const override {
+		// Files are made in the upper directory through the anchor, which notifies the context instead.
+		watch.add(std::shared_ptr<ChangeCounter const>(this->context_, &this->context_->changes));
+		this->origin_->watch_changes(watch);
+	}
+
 	[[nodiscard]] Anchor_ const& anchor() const {
 		return this->anchor_;
 	}
@@ -460,7 +520,7 @@ bool UnionDirectory::empty() const {
 	}
 
 	for(auto cursor = this->lower_->cursor(); !cursor->at_end(); cursor->increment()) {
-		if(!this->context_->hidden.contains(cursor->name())) {
+		if(!this->context_->is_hidden(cursor->name())) {
 			return false;
 		}
 	}
@@ -472,7 +532,7 @@ bool UnionDirectory::contains(std::string const& name) const {
 	if(this->origin_->contains(name)) {
 		return true;
 	}
-	if(this->context_->hidden.contains(name)) {
+	if(this->context_->is_hidden(name)) {
 		return false;
 	}
 
@@ -632,53 +692,56 @@ bool UnionDirectory::link(std::string const& name, std::shared_ptr<File> file) {
 
 bool UnionDirectory::unlink(std::string const& name) {
 	if(this->origin_->unlink(name)) {
-		this->context_->hidden.insert(name);
+		this->context_->hide(name);
 		return true;
 	}
 
-	if(this->context_->hidden.contains(name)) {
+	if(this->context_->is_hidden(name)) {
 		return false;
 	}
 	if(!this->lower_->contains(name)) {
 		return false;
 	}
 
-	auto const [_, ok] = this->context_->hidden.insert(name);
+	auto const ok = this->context_->hide(name);
+	if(ok) {
+		this->context_->changes.notify_removed();
+	}
+
 	return ok;
 }
 
 std::uintmax_t UnionDirectory::erase(std::string const& name) {
-	auto& hidden = this->context_->hidden;
-
 	if(auto const cnt = this->origin_->erase(name); cnt > 0) {
-		hidden.insert(name);
+		this->context_->hide(name);
 		return cnt;
 	}
 
-	if(hidden.contains(name)) {
+	if(this->context_->is_hidden(name)) {
 		return 0;
 	}
 	if(!this->lower_->contains(name)) {
 		return 0;
 	}
 
-	auto const [_, ok] = hidden.insert(name);
-	assert(ok);
+	if(!this->context_->hide(name)) {
+		return 0;
+	}
+
+	this->context_->changes.notify_removed();
 
 	auto const cnt = count_files_(*this->context_, *this->lower_);
 	return cnt;
 }
 
 std::uintmax_t UnionDirectory::clear() {
-	auto& hidden = this->context_->hidden;
-
 	for(auto const& [name, _]: *this->origin_) {
-		hidden.insert(name);
+		this->context_->hide(name);
 	}
 
 	std::size_t cnt = 0;
 	for(auto const& [name, file]: *this->lower_) {
-		auto const [_, ok] = hidden.insert(name);
+		auto const ok = this->context_->hide(name);
 		if(!ok) {
 			continue;
 		}
@@ -687,6 +750,10 @@ std::uintmax_t UnionDirectory::clear() {
 	}
 
 	cnt += this->origin_->clear();
+	if(cnt > 0) {
+		this->context_->changes.notify_removed();
+	}
+
 	return cnt;
 }
 
@@ -710,8 +777,14 @@ std::shared_ptr<Directory::Cursor> UnionDirectory::cursor() const {
 	return std::make_shared<StaticCursor>(std::move(files));
 }
 
+void UnionDirectory::watch_changes(ChangeWatch& watch) const {
+	watch.add(std::shared_ptr<ChangeCounter const>(this->context_, &this->context_->changes));
+	this->origin_->watch_changes(watch);
+	this->lower_->watch_changes(watch);
+}
+
 std::shared_ptr<File> UnionDirectory::lower_next_(std::string const& name) const {
-	if(this->context_->hidden.contains(name)) {
+	if(this->context_->is_hidden(name)) {
 		return nullptr;
 	}
 
@@ -719,16 +792,31 @@ std::shared_ptr<File> UnionDirectory::lower_next_(std::string const& name) const
 }
 
 std::shared_ptr<UnionDirectory::Context> UnionDirectory::Context::at(std::string const& name) {
-	auto& child_ctx = this->child_context;
+	{
+		std::shared_lock const lock(this->mutex_);
+		if(auto it = this->child_context_.find(name); it != this->child_context_.end()) {
+			return it->second;
+		}
+	}
 
-	auto it = child_ctx.find(name);
-	if(it != child_ctx.end()) {
-		return it->second;
+	std::unique_lock const lock(this->mutex_);
+
+	auto [it, _] = this->child_context_.try_emplace(name);
+	if(!it->second) {
+		it->second = std::make_shared<Context>();
 	}
 
-	auto ctx = std::make_shared<Context>();
-	child_ctx.insert(std::make_pair(name, ctx));
-	return ctx;
+	return it->second;
+}
+
+bool UnionDirectory::Context::is_hidden(std::string const& name) const {
+	std::shared_lock const lock(this->mutex_);
+	return this->hidden_.contains(name);
+}
+
+bool UnionDirectory::Context::hide(std::string const& name) {
+	std::unique_lock const lock(this->mutex_);
+	return this->hidden_.emplace(name).second;
 }
 
 }  // namespace impl
@@ -1,6 +1,7 @@
 #include "vfs/impl/utils.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <numeric>
@@ -13,19 +14,54 @@ namespace impl {
 
 namespace {
 
-std::mt19937& random_engine_() {
-	static std::mt19937 engine(std::random_device{}());
+// wyrand; much cheaper than `std::mt19937` and its state fits in a register.
+class RandomEngine_ {
+   public:
+	RandomEngine_() {
+		std::random_device d;
+		this->state_ = (static_cast<std::uint64_t>(d()) << 32) | d();
+	}
+
+	std::uint64_t operator()() noexcept {
+		this->state_ += 0xA0761D6478BD642F;
+
+		auto const t = static_cast<unsigned __int128>(this->state_) * (this->state_ ^ 0xE7037ED1A0B428DB);
+		return static_cast<std::uint64_t>(t >> 64) ^ static_cast<std::uint64_t>(t);
+	}
+
+   private:
+	std::uint64_t state_ = 0;
+};
+
+RandomEngine_& random_engine_() {
+	thread_local RandomEngine_ engine;
 	return engine;
 }
 
 }  // namespace
 
 std::string random_string(std::size_t len, std::string_view char_set) {
-	std::uniform_int_distribution<std::size_t> distribution{0, char_set.size() - 1};
-
 	std::string rst(len, char_set.at(0));
-	for(auto& c: rst) {
-		c = char_set[distribution(random_engine_())];
+
+	auto&      engine = random_engine_();
+	auto const n      = char_set.size();
+	if(n > 256) {
+		for(auto& c: rst) {
+			c = char_set[static_cast<std::size_t>((static_cast<unsigned __int128>(engine()) * n) >> 64)];
+		}
+		return rst;
+	}
+
+	// Each draw gives 8 bytes; bytes at or above `limit` are dropped so no character is biased.
+	auto const limit = 256 - (256 % n);
+	for(std::size_t i = 0; i < len;) {
+		auto bits = engine();
+		for(auto j = 0; j < 8 && i < len; ++j, bits >>= 8) {
+			auto const b = static_cast<std::size_t>(bits & 0xFF);
+			if(b < limit) {
+				rst[i++] = char_set[b % n];
+			}
+		}
 	}
 
 	return rst;
@@ -1,16 +1,25 @@
 #include "vfs/impl/vfile.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "vfs/impl/file.hpp"
 #include "vfs/impl/file_proxy.hpp"
+#include "vfs/impl/lookup_cache.hpp"
+#include "vfs/impl/mem_file.hpp"
 #include "vfs/impl/mount_point.hpp"
 
 namespace fs = std::filesystem;
@@ -44,10 +53,198 @@ void VFile::perms(fs::perms prms, fs::perm_options opts) {
 	}
 }
 
-VRegularFile::VRegularFile(fs::perms perms)
-    : VFile(perms) { }
+// Counts as a writer of the file while alive.
+class VRegularFile::Writing_ {
+   public:
+	Writing_(VRegularFile& file, std::uintmax_t size, bool keep)
+	    : file_(file)
+	    , storage_(file.begin_write_(size, keep)) { }
+
+	Writing_(Writing_ const& other) = delete;
+	Writing_(Writing_&& other)      = delete;
+
+	~Writing_() {
+		this->file_.end_write_();
+	}
+
+	Writing_& operator=(Writing_ const& other) = delete;
+	Writing_& operator=(Writing_&& other)      = delete;
+
+	[[nodiscard]] RegularFile& storage() const {
+		return *this->storage_;
+	}
+
+   private:
+	VRegularFile& file_;
+
+	std::shared_ptr<RegularFile> storage_;
+};
+
+// Keeps the storage from being moved while the handle is open, since the handle is bound to it.
+class VRegularFile::Handle_: public FileHandle {
+   public:
+	Handle_(std::shared_ptr<FileHandle> handle, std::weak_ptr<VRegularFile> file)
+	    : handle_(std::move(handle))
+	    , file_(std::move(file)) { }
+
+	Handle_(Handle_ const& other) = delete;
+	Handle_(Handle_&& other)      = delete;
+
+	~Handle_() override {
+		this->handle_.reset();
+		if(auto f = this->file_.lock(); f) {
+			f->end_write_();
+		}
+	}
+
+	Handle_& operator=(Handle_ const& other) = delete;
+	Handle_& operator=(Handle_&& other)      = delete;
+
+	std::size_t pread(std::span<char> buf, std::uintmax_t offset) override {
+		return this->handle_->pread(buf, offset);
+	}
+
+	void pwrite(std::string_view data, std::uintmax_t offset) override {
+		this->handle_->pwrite(data, offset);
+	}
+
+	[[nodiscard]] std::uintmax_t size() const override {
+		return this->handle_->size();
+	}
+
+	void truncate(std::uintmax_t n) override {
+		this->handle_->truncate(n);
+	}
+
+	void sync() override {
+		this->handle_->sync();
+	}
+
+   private:
+	std::shared_ptr<FileHandle> handle_;
+
+	std::weak_ptr<VRegularFile> file_;
+};
+
+VRegularFile::VRegularFile(fs::perms perms, std::uintmax_t spill_size)
+    : VFile(perms)
+    , storage_(std::make_shared<MemRegularFile>())
+    , spill_size_(spill_size) { }
+
+void VRegularFile::copy_from(RegularFile const& other) {
+	auto const* src = &other;
+
+	// Let the storage share pages or copy in the kernel.
+	std::shared_ptr<RegularFile> src_storage;
+	if(auto const* v = dynamic_cast<VRegularFile const*>(&other); v != nullptr) {
+		src_storage = v->current_();
+		src         = src_storage.get();
+	}
+
+	{
+		Writing_ const w(*this, src->size(), false);
+		w.storage().copy_from(*src);
+
+		// Permissions are of this file; the storage stays writable.
+		w.storage().perms(DefaultPerms, fs::perm_options::replace);
+	}
+
+	this->perms(other.perms(), fs::perm_options::replace);
+}
+
+void VRegularFile::resize(std::uintmax_t new_size) {
+	Writing_ const w(*this, new_size, true);
+	w.storage().resize(new_size);
+}
+
+std::shared_ptr<std::ostream> VRegularFile::open_write(std::ios_base::openmode mode) {
+	auto const storage = this->begin_write_(0, true);
+
+	std::shared_ptr<std::ostream> os;
+	try {
+		os = storage->open_write(mode);
+	} catch(...) {
+		this->end_write_();
+		throw;
+	}
+
+	auto* const p = os.get();
+	return std::shared_ptr<std::ostream>(p, [os = std::move(os), file = this->weak_from_this()](std::ostream*) mutable {
+		// Written data is committed on release of the stream.
+		os.reset();
+		if(auto f = file.lock(); f) {
+			f->end_write_();
+		}
+	});
+}
+
+void VRegularFile::write_all(std::string_view data, std::ios_base::openmode mode) {
+	auto const app = (mode & std::ios_base::app) == std::ios_base::app;
+
+	Writing_ const w(*this, (app ? this->size() : 0) + data.size(), app);
+	w.storage().write_all(data, mode);
+}
+
+std::shared_ptr<FileHandle> VRegularFile::open_handle(std::ios_base::openmode mode) {
+	auto const storage = this->begin_write_(0, true);
+	try {
+		return std::make_shared<Handle_>(storage->open_handle(mode), this->weak_from_this());
+	} catch(...) {
+		this->end_write_();
+		throw;
+	}
+}
+
+std::shared_ptr<RegularFile> VRegularFile::begin_write_(std::uintmax_t size, bool keep) {
+	std::lock_guard const lock(this->mutex_);
+	if(this->writers_ == 0 && this->in_memory_) {
+		if(size >= this->spill_size_ || (keep && this->storage_->size() >= this->spill_size_)) {
+			this->spill_(keep);
+		}
+	}
+
+	++this->writers_;
+	return this->storage_;
+}
+
+void VRegularFile::end_write_() noexcept {
+	std::lock_guard const lock(this->mutex_);
+	--this->writers_;
+}
+
+void VRegularFile::spill_(bool keep) {
+	std::shared_ptr<TempRegularFile> f;
+	try {
+		f = std::make_shared<TempRegularFile>();
+		if(keep) {
+			f->copy_from(*this->storage_);
+			f->perms(DefaultPerms, fs::perm_options::replace);
+		}
+		f->last_write_time(this->storage_->last_write_time());
+	} catch(fs::filesystem_error const&) {
+		return;
+	}
+
+	this->storage_   = std::move(f);
+	this->in_memory_ = false;
+}
+
+namespace {
+
+std::vector<std::pair<Name, std::shared_ptr<File>>> entries_of_(HashedFiles const& files) {
+	return {files.begin(), files.end()};
+}
+
+std::vector<SortedFiles::value_type> const& entries_of_(SortedFiles const& files) {
+	return files.entries();
+}
+
+}  // namespace
+
+template<typename Files>
+std::shared_ptr<File> BasicVDirectory<Files>::next(std::string const& name) const {
+	std::shared_lock const lock(this->mutex_);
 
-std::shared_ptr<File> VDirectory::next(std::string const& name) const {
 	auto it = this->files_.find(name);
 	if(it == this->files_.end()) {
 		return nullptr;
@@ -56,20 +253,26 @@ std::shared_ptr<File> VDirectory::next(std::string const& name) const {
 	return it->second;
 }
 
-std::uintmax_t VDirectory::erase(std::string const& name) {
-	auto node = this->files_.extract(name);
-	if(node.empty()) {
-		return 0;
-	}
+template<typename Files>
+std::uintmax_t BasicVDirectory<Files>::erase(std::string const& name) {
+	std::shared_ptr<File> f;
+	{
+		std::unique_lock const lock(this->mutex_);
 
-	auto f = node.mapped();
-	if(auto m = std::dynamic_pointer_cast<MountPoint>(std::move(f)); m) {
-		node.mapped() = std::move(m);
-		this->files_.insert(std::move(node));
+		auto it = this->files_.find(name);
+		if(it == this->files_.end()) {
+			return 0;
+		}
+		if(std::dynamic_pointer_cast<MountPoint>(it->second)) {
+			throw fs::filesystem_error("", "", std::make_error_code(std::errc::device_or_resource_busy));
+		}
 
-		throw fs::filesystem_error("", "", std::make_error_code(std::errc::device_or_resource_busy));
+		f = std::move(it->second);
+		this->files_.erase(it);
 	}
 
+	this->changes_->notify_removed();
+
 	auto d = std::dynamic_pointer_cast<Directory>(f);
 	if(!d) {
 		return 1;
@@ -78,14 +281,22 @@ std::uintmax_t VDirectory::erase(std::string const& name) {
 	return d->clear() + 1;
 }
 
-std::uintmax_t VDirectory::clear() {
-	auto files = std::move(this->files_);
-	for(auto const& [_, f]: files) {
-		if(auto m = std::dynamic_pointer_cast<MountPoint>(f); m) {
-			this->files_ = std::move(files);
-
-			throw fs::filesystem_error("", "", std::make_error_code(std::errc::device_or_resource_busy));
+template<typename Files>
+std::uintmax_t BasicVDirectory<Files>::clear() {
+	Files files;
+	{
+		std::unique_lock const lock(this->mutex_);
+		for(auto const& [_, f]: this->files_) {
+			if(auto m = std::dynamic_pointer_cast<MountPoint>(f); m) {
+				throw fs::filesystem_error("", "", std::make_error_code(std::errc::device_or_resource_busy));
+			}
 		}
+
+		files = std::exchange(this->files_, Files{});
+	}
+
+	if(!files.empty()) {
+		this->changes_->notify_removed();
 	}
 
 	std::uintmax_t n = 0;
@@ -101,22 +312,26 @@ std::uintmax_t VDirectory::clear() {
 	return n;
 }
 
-std::pair<std::shared_ptr<RegularFile>, bool> VDirectory::emplace_regular_file(std::string const& name) {
-	auto [it, ok] = this->files_.emplace(name, std::make_shared<VRegularFile>());
-	return std::make_pair(std::dynamic_pointer_cast<RegularFile>(it->second), ok);
+template<typename Files>
+std::pair<std::shared_ptr<RegularFile>, bool> BasicVDirectory<Files>::emplace_regular_file(std::string const& name) {
+	auto [f, ok] = this->emplace_(name, [] { return std::make_shared<VRegularFile>(); });
+	return std::make_pair(std::dynamic_pointer_cast<RegularFile>(std::move(f)), ok);
 }
 
-std::pair<std::shared_ptr<Directory>, bool> VDirectory::emplace_directory(std::string const& name) {
-	auto [it, ok] = this->files_.emplace(name, std::make_shared<VDirectory>());
-	return std::make_pair(std::dynamic_pointer_cast<Directory>(it->second), ok);
+template<typename Files>
+std::pair<std::shared_ptr<Directory>, bool> BasicVDirectory<Files>::emplace_directory(std::string const& name) {
+	auto [f, ok] = this->emplace_(name, [this] { return std::make_shared<BasicVDirectory>(DefaultPerms, this->concurrent()); });
+	return std::make_pair(std::dynamic_pointer_cast<Directory>(std::move(f)), ok);
 }
 
-std::pair<std::shared_ptr<Symlink>, bool> VDirectory::emplace_symlink(std::string const& name, std::filesystem::path target) {
-	auto [it, ok] = this->files_.emplace(name, std::make_shared<VSymlink>(std::move(target)));
-	return std::make_pair(std::dynamic_pointer_cast<Symlink>(it->second), ok);
+template<typename Files>
+std::pair<std::shared_ptr<Symlink>, bool> BasicVDirectory<Files>::emplace_symlink(std::string const& name, std::filesystem::path target) {
+	auto [f, ok] = this->emplace_(name, [&target] { return std::make_shared<VSymlink>(std::move(target)); });
+	return std::make_pair(std::dynamic_pointer_cast<Symlink>(std::move(f)), ok);
 }
 
-bool VDirectory::link(std::string const& name, std::shared_ptr<File> file) {
+template<typename Files>
+bool BasicVDirectory<Files>::link(std::string const& name, std::shared_ptr<File> file) {
 	if(auto proxy = std::dynamic_pointer_cast<FileProxy>(std::move(file)); proxy) {
 		file = proxy->origin();
 	}
@@ -126,13 +341,86 @@ bool VDirectory::link(std::string const& name, std::shared_ptr<File> file) {
 		throw fs::filesystem_error("cannot create link to different type of filesystem", std::make_error_code(std::errc::cross_device_link));
 	}
 
-	auto const [_, ok] = this->files_.insert(std::make_pair(name, std::move(f)));
-	return ok;
+	return this->emplace_(name, [&f] { return std::move(f); }).second;
 }
 
-std::shared_ptr<Directory::Cursor> VDirectory::cursor() const {
-	return std::make_shared<StaticCursor>(this->files_);
+template<typename Files>
+bool BasicVDirectory<Files>::unlink(std::string const& name) {
+	{
+		std::unique_lock const lock(this->mutex_);
+
+		auto const it = this->files_.find(name);
+		if(it == this->files_.end()) {
+			return false;
+		}
+
+		this->files_.erase(it);
+	}
+
+	this->changes_->notify_removed();
+	return true;
+}
+
+template<typename Files>
+bool BasicVDirectory<Files>::move(std::string const& name, Directory& dst, std::string const& dst_name) {
+	auto* const d = dynamic_cast<BasicVDirectory*>(&dst);
+	if(d == nullptr) {
+		return false;
+	}
+	if(d == this && name == dst_name) {
+		return true;
+	}
+
+	std::shared_ptr<File> replaced;
+	{
+		// Locks both in a deadlock-free order; `std::scoped_lock` must not lock the same mutex twice.
+		std::unique_lock src_lock(this->mutex_, std::defer_lock);
+		std::unique_lock dst_lock(d->mutex_, std::defer_lock);
+		if(d == this) {
+			src_lock.lock();
+		} else {
+			std::lock(src_lock, dst_lock);
+		}
+
+		auto const src_it = this->files_.find(name);
+		if(src_it == this->files_.end()) {
+			throw fs::filesystem_error("", name, std::make_error_code(std::errc::no_such_file_or_directory));
+		}
+
+		auto f = src_it->second;
+		if(auto const dst_it = d->files_.find(dst_name); dst_it != d->files_.end()) {
+			if(std::dynamic_pointer_cast<MountPoint>(dst_it->second)) {
+				throw fs::filesystem_error("", dst_name, std::make_error_code(std::errc::device_or_resource_busy));
+			}
+
+			replaced = std::exchange(dst_it->second, std::move(f));
+		} else {
+			d->files_.emplace(Name(dst_name), std::move(f));
+		}
+
+		// Emplacing may invalidate `src_it` if both are the same directory.
+		this->files_.erase(this->files_.find(name));
+	}
+
+	this->changes_->notify_removed();
+	if(d != this) {
+		d->changes_->notify_removed();
+	}
+	if(auto const replaced_d = std::dynamic_pointer_cast<Directory>(std::move(replaced)); replaced_d) {
+		replaced_d->clear();
+	}
+
+	return true;
 }
 
+template<typename Files>
+std::shared_ptr<Directory::Cursor> BasicVDirectory<Files>::cursor() const {
+	std::shared_lock const lock(this->mutex_);
+	return std::make_shared<StaticCursor>(entries_of_(this->files_));
+}
+
+template class BasicVDirectory<HashedFiles>;
+template class BasicVDirectory<SortedFiles>;
+
 }  // namespace impl
 }  // namespace vfs
@@ -3,17 +3,25 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <span>
+#include <string>
+#include <string_view>
 #include <system_error>
 #include <utility>
 
 #include "vfs/fs.hpp"
 
 #include "vfs/impl/entry.hpp"
+#include "vfs/impl/io_engine.hpp"
+#include "vfs/impl/lookup_cache.hpp"
 #include "vfs/impl/mount_point.hpp"
+#include "vfs/impl/os_file.hpp"
 #include "vfs/impl/utils.hpp"
 #include "vfs/impl/vfile.hpp"
 
@@ -49,13 +57,26 @@ Vfs::Vfs(Vfs const& other, DirectoryEntry& wd)
     : Vfs(
         other.root_,
         wd.shared_from_this()->must_be<DirectoryEntry>(),
-        other.temp_) { }
+        other.temp_) {
+	this->apply(other.opts_);
+}
 
 Vfs::Vfs(Vfs&& other, DirectoryEntry& wd)
     : Vfs(
         std::move(other.root_),
         wd.shared_from_this()->must_be<DirectoryEntry>(),
-        std::move(other.temp_)) { }
+        std::move(other.temp_)) {
+	this->apply(other.opts_);
+}
+
+void Vfs::apply(VfsOptions const& opts) {
+	this->opts_ = opts;
+	if(!opts.cache_lookups) {
+		this->cache_.reset();
+	} else {
+		this->cache_ = std::make_shared<LookupCache>(opts.concurrent);
+	}
+}
 
 std::shared_ptr<std::istream> Vfs::open_read(fs::path const& filename, std::ios_base::openmode mode) const {
 	constexpr auto fail = [] {
@@ -66,70 +87,143 @@ std::shared_ptr<std::istream> Vfs::open_read(fs::path const& filename, std::ios_
 
 	mode |= std::ios_base::in;
 
-	auto ec = std::error_code();
-	auto f  = this->navigate(filename, ec);
-	if(ec) {
-		return fail();
-	}
+	std::error_code ec;
 
-	auto r = std::dynamic_pointer_cast<RegularFileEntry const>(std::move(f));
+	auto r = std::dynamic_pointer_cast<RegularFile const>(this->lookup_(filename, false, ec));
 	if(!r) {
 		return fail();
 	}
 
-	return r->typed_file()->open_read(mode);
+	return r->open_read(mode);
 }
 
 std::shared_ptr<std::ostream> Vfs::open_write(fs::path const& filename, std::ios_base::openmode mode) {
 	mode |= std::ios_base::out;
 
-	constexpr auto fail = [] {
+	std::error_code ec;
+
+	auto const r = this->regular_file_for_write_(filename, ec);
+	if(!r) {
 		auto f = std::make_shared<std::ofstream>();
 		f->setstate(std::ios_base::failbit);
 		return f;
-	};
+	}
 
-	auto ec      = std::error_code();
-	auto [f, it] = this->navigate(filename.begin(), filename.end(), ec);
-	if(!ec) {
-		auto const r = std::dynamic_pointer_cast<RegularFile>(std::move(f));
+	return r->open_write(mode);
+}
+
+std::string Vfs::read_file(fs::path const& filename) const {
+	return this->regular_file_for_read_(filename)->read_all();
+}
+
+std::size_t Vfs::read_at(fs::path const& filename, std::uintmax_t offset, std::span<char> buf) const {
+	return this->regular_file_for_read_(filename)->read_at(offset, buf);
+}
+
+std::shared_ptr<std::istream> Vfs::map_read(fs::path const& filename) const {
+	return this->regular_file_for_read_(filename)->map_read();
+}
+
+void Vfs::write_file(fs::path const& filename, std::string_view data, std::ios_base::openmode mode) {
+	std::error_code ec;
+
+	auto const r = this->regular_file_for_write_(filename, ec);
+	if(!r) {
+		throw fs::filesystem_error("", filename, ec);
+	}
+
+	r->write_all(data, mode);
+}
+
+std::shared_ptr<FileHandle> Vfs::open_file(fs::path const& filename) const {
+	auto const r = std::const_pointer_cast<RegularFile>(this->regular_file_for_read_(filename));
+	return r->open_handle(std::ios_base::in);
+}
+
+std::shared_ptr<FileHandle> Vfs::open_file(fs::path const& filename, std::ios_base::openmode mode) {
+	if((mode & std::ios_base::out) == 0) {
+		return static_cast<Vfs const*>(this)->open_file(filename);
+	}
+
+	std::error_code ec;
+
+	auto const r = this->regular_file_for_write_(filename, ec);
+	if(!r) {
+		throw fs::filesystem_error("", filename, ec);
+	}
+
+	return r->open_handle(mode);
+}
+
+std::shared_ptr<RegularFile const> Vfs::regular_file_for_read_(fs::path const& filename) const {
+	auto const f = this->lookup_(filename, true);
+	if(f->type() == fs::file_type::directory) {
+		throw fs::filesystem_error("", filename, std::make_error_code(std::errc::is_a_directory));
+	}
+
+	auto r = std::dynamic_pointer_cast<RegularFile const>(f);
+	if(!r) {
+		throw fs::filesystem_error("", filename, std::make_error_code(std::errc::invalid_argument));
+	}
+
+	return r;
+}
+
+std::shared_ptr<RegularFile> Vfs::regular_file_for_write_(fs::path const& filename, std::error_code& ec) {
+	auto t  = Trail(this->from_of_(filename));
+	auto it = filename.begin();
+	try {
+		t.walk(it, filename.end());
+
+		auto r = std::dynamic_pointer_cast<RegularFile>(t.file());
 		if(!r) {
 			// File exists but not a regular file.
-			return fail();
+			ec = std::make_error_code(t.file()->type() == fs::file_type::directory ? std::errc::is_a_directory : std::errc::invalid_argument);
 		}
 
-		return r->open_write(mode);
+		return r;
+	} catch(fs::filesystem_error const& err) {
 	}
 
-	auto d = std::dynamic_pointer_cast<DirectoryEntry>(std::move(f));
+	auto d = std::dynamic_pointer_cast<Directory>(t.file());
 	if(!d) {
-		return fail();
+		ec = std::make_error_code(std::errc::not_a_directory);
+		return nullptr;
 	}
 
 	auto const name = acc_paths(it, filename.end());
 	if(std::distance(name.begin(), name.end()) > 1) {
 		// No such directory.
-		return fail();
+		ec = std::make_error_code(std::errc::no_such_file_or_directory);
+		return nullptr;
 	}
 
 	if(name.empty() || name.is_absolute() || name == "." || name == "..") {
 		// Not a filename.
-		return fail();
+		ec = std::make_error_code(std::errc::invalid_argument);
+		return nullptr;
 	}
 
-	auto r = d->emplace_regular_file(name);
-	return r->open_write(mode);
+	auto [r, ok] = d->emplace_regular_file(name);
+	if(!r) {
+		ec = std::make_error_code(std::errc::file_exists);
+	}
+
+	return r;
 }
 
 std::shared_ptr<Fs const> Vfs::change_root(std::filesystem::path const& p, std::filesystem::path const& temp_dir) const {
 	auto d    = this->navigate(p / "")->must_be<DirectoryEntry const>();
 	auto root = std::make_shared<DirectoryEntry>("/", nullptr, std::const_pointer_cast<Directory>(d->typed_file()));
 
-	return std::make_shared<Vfs>(root, nullptr, temp_dir);
+	auto vfs = std::make_shared<Vfs>(root, nullptr, temp_dir);
+	vfs->apply(this->opts_);
+
+	return vfs;
 }
 
 fs::path Vfs::canonical(fs::path const& p) const {
-	return this->navigate(p)->follow_chain()->path();
+	return this->trail_followed(p).path();
 }
 
 fs::path Vfs::weakly_canonical(fs::path const& p) const {
@@ -299,51 +393,53 @@ bool Vfs::equivalent(fs::path const& p1, fs::path const& p2) const {
 }
 
 std::uintmax_t Vfs::file_size(fs::path const& p) const {
-	auto const f = this->navigate(p)->follow_chain();
-	if(auto const d = std::dynamic_pointer_cast<DirectoryEntry const>(f); d) {
-		throw fs::filesystem_error("", f->path(), std::make_error_code(std::errc::is_a_directory));
+	auto const f = this->file_at_followed(p);
+	if(f->type() == fs::file_type::directory) {
+		throw fs::filesystem_error("", p, std::make_error_code(std::errc::is_a_directory));
 	}
 
-	auto const r = std::dynamic_pointer_cast<RegularFileEntry const>(f);
+	auto const r = std::dynamic_pointer_cast<RegularFile const>(f);
 	if(!r) {
-		throw fs::filesystem_error("", f->path(), std::make_error_code(std::errc::invalid_argument));
+		throw fs::filesystem_error("", p, std::make_error_code(std::errc::invalid_argument));
 	}
 
-	return r->typed_file()->size();
+	return r->size();
 }
 
 std::uintmax_t Vfs::hard_link_count(fs::path const& p) const {
-	auto const f = this->navigate(p)->file();
+	auto const f = this->trail(p).file();
+	if(auto const* os = dynamic_cast<OsFile const*>(f.get()); os != nullptr) {
+		// Links of OS files are not held by this file system.
+		return fs::hard_link_count(os->path());
+	}
 	return f.use_count() - 1;  // Minus one for being held by `f`.
 }
 
 fs::file_time_type Vfs::last_write_time(fs::path const& p) const {
-	auto const f = this->navigate(p)->follow_chain();
-	return f->file()->last_write_time();
+	return this->file_at_followed(p)->last_write_time();
 }
 
 void Vfs::last_write_time(fs::path const& p, fs::file_time_type t) {
-	auto const f = this->navigate(p)->follow_chain();
-	f->file()->last_write_time(t);
+	this->file_at_followed(p)->last_write_time(t);
 }
 
 void Vfs::permissions(fs::path const& p, fs::perms prms, fs::perm_options opts) {
-	auto f = this->navigate(p);
+	auto t = this->trail(p);
 	if((opts & fs::perm_options::nofollow) != fs::perm_options::nofollow) {
-		f = f->follow_chain();
+		t.follow_chain();
 	}
 
-	f->file()->perms(prms, opts);
+	t.file()->perms(prms, opts);
 }
 
 fs::path Vfs::read_symlink(fs::path const& p) const {
-	auto const f = this->navigate(p);
-	auto const s = std::dynamic_pointer_cast<SymlinkEntry const>(f);
+	auto const t = this->trail(p);
+	auto const s = std::dynamic_pointer_cast<Symlink const>(t.file());
 	if(!s) {
-		throw fs::filesystem_error("", f->path(), std::make_error_code(std::errc::invalid_argument));
+		throw fs::filesystem_error("", t.path(), std::make_error_code(std::errc::invalid_argument));
 	}
 
-	return s->typed_file()->target();
+	return s->target();
 }
 
 bool Vfs::remove(fs::path const& p) {
@@ -428,6 +524,12 @@ void Vfs::rename(fs::path const& src, fs::path const& dst) {
 		}
 
 		throw_if_not_overwritable_(src_f->file(), f, dst_p);
+	}
+
+	if(src_f->prev()->typed_file()->move(src_f->name(), *prev->typed_file(), dst_p.filename())) {
+		return;
+	}
+	if(prev->typed_file()->contains(dst_p.filename())) {
 		prev->typed_file()->erase(dst_p.filename());
 	}
 
@@ -457,6 +559,8 @@ void Vfs::rename(fs::path const& src, fs::path const& dst) {
 
 		// Both source and destination are OsFile so simply move.
 		src_os_f->move_to(prev_os_f->path() / dst_p.filename());
+		src_os_f->context()->changes.notify_removed();
+		prev_os_f->context()->changes.notify_removed();
 
 		// Note that prev of source cannot be a VDirectory
 		// since if it is, source is a mount point and the source cannot be renamed.
@@ -467,61 +571,122 @@ void Vfs::rename(fs::path const& src, fs::path const& dst) {
 }
 
 void Vfs::resize_file(fs::path const& p, std::uintmax_t n) {
-	auto const f = this->navigate(p)->follow_chain();
-	if(auto const d = std::dynamic_pointer_cast<DirectoryEntry>(f); d) {
-		throw fs::filesystem_error("", f->path(), std::make_error_code(std::errc::is_a_directory));
+	auto const t = this->trail_followed(p);
+	auto const f = t.file();
+	if(f->type() == fs::file_type::directory) {
+		throw fs::filesystem_error("", t.path(), std::make_error_code(std::errc::is_a_directory));
 	}
 
-	auto const r = std::dynamic_pointer_cast<RegularFileEntry>(f);
+	auto const r = std::dynamic_pointer_cast<RegularFile>(f);
 	if(!r) {
-		throw fs::filesystem_error("", f->path(), std::make_error_code(std::errc::invalid_argument));
+		throw fs::filesystem_error("", t.path(), std::make_error_code(std::errc::invalid_argument));
 	}
 
-	r->typed_file()->resize(n);
+	r->resize(n);
 }
 
 fs::space_info Vfs::space(fs::path const& p) const {
-	return this->navigate(p)->follow_chain()->file()->space();
+	return this->file_at_followed(p)->space();
 }
 
 fs::file_status Vfs::status(fs::path const& p) const {
-	try {
-		auto const f = this->navigate(p)->follow_chain()->file();
+	std::error_code ec;
+
+	auto const f = this->lookup_(p, true, ec);
+	if(f) {
 		return fs::file_status(f->type(), f->perms());
+	}
+
+	switch(static_cast<std::errc>(ec.value())) {
+	case std::errc::no_such_file_or_directory:
+	case std::errc::not_a_directory: {
+		return fs::file_status(fs::file_type::not_found);
+	}
+
+	default: {
+		break;
+	}
+	}
+
+	throw fs::filesystem_error("", p, ec);
+}
+
+void Vfs::async_read_file(fs::path const& filename, std::function<void(std::error_code, std::string)> callback) const {
+	std::error_code ec;
+
+	auto const r = handle_error([&] { return this->regular_file_for_read_(filename); }, ec);
+	if(auto const* os = dynamic_cast<OsRegularFile const*>(r.get()); os != nullptr) {
+		IoEngine::instance().read_file(os->path(), std::move(callback));
+		return;
+	}
+
+	auto data = r ? handle_error([&] { return r->read_all(); }, ec) : std::string();
+	callback(ec, std::move(data));
+}
+
+void Vfs::async_write_file(fs::path const& filename, std::string data, std::ios_base::openmode mode, std::function<void(std::error_code)> callback) {
+	std::error_code ec;
+
+	std::shared_ptr<RegularFile> r;
+	try {
+		r = this->regular_file_for_write_(filename, ec);
 	} catch(fs::filesystem_error const& err) {
-		switch(static_cast<std::errc>(err.code().value())) {
-		case std::errc::no_such_file_or_directory:
-		case std::errc::not_a_directory: {
-			return fs::file_status(fs::file_type::not_found);
-		}
+		ec = err.code();
+	}
 
-		default: {
-			break;
-		}
-		}
+	if(auto os = std::dynamic_pointer_cast<OsRegularFile>(r); os) {
+		os->refresh();
+
+		auto p = os->path();
+		IoEngine::instance().write_file(std::move(p), std::move(data), mode, [os = std::move(os), callback = std::move(callback)](std::error_code ec) {
+			os->refresh();
+			callback(ec);
+		});
+		return;
+	}
+
+	if(r) {
+		handle_error([&] { r->write_all(data, mode); return 0; }, ec);
+	}
+	callback(ec);
+}
+
+void Vfs::async_status(fs::path const& p, std::function<void(std::error_code, fs::file_status)> callback) const {
+	std::error_code ec;
 
-		throw err;
+	auto const f = this->lookup_(p, true, ec);
+	if(auto const* os = dynamic_cast<OsFile const*>(f.get()); os != nullptr) {
+		IoEngine::instance().status(os->path(), std::move(callback));
+		return;
+	}
+	if(f) {
+		callback({}, fs::file_status(f->type(), f->perms()));
+		return;
 	}
+
+	this->FsBase::async_status(p, std::move(callback));
 }
 
 fs::file_status Vfs::symlink_status(fs::path const& p) const {
-	try {
-		auto const f = this->navigate(p)->file();
+	std::error_code ec;
+
+	auto const f = this->lookup_(p, false, ec);
+	if(f) {
 		return fs::file_status(f->type(), f->perms());
-	} catch(fs::filesystem_error const& err) {
-		switch(static_cast<std::errc>(err.code().value())) {
-		case std::errc::no_such_file_or_directory:
-		case std::errc::not_a_directory: {
-			return fs::file_status(fs::file_type::not_found);
-		}
+	}
 
-		default: {
-			break;
-		}
-		}
+	switch(static_cast<std::errc>(ec.value())) {
+	case std::errc::no_such_file_or_directory:
+	case std::errc::not_a_directory: {
+		return fs::file_status(fs::file_type::not_found);
+	}
 
-		throw err;
+	default: {
+		break;
+	}
 	}
+
+	throw fs::filesystem_error("", p, ec);
 }
 
 fs::path Vfs::temp_directory_path() const {
@@ -533,26 +698,199 @@ fs::path Vfs::temp_directory_path() const {
 }
 
 bool Vfs::is_empty(fs::path const& p) const {
-	auto const f = this->navigate(p);
-	if(auto d = std::dynamic_pointer_cast<DirectoryEntry const>(f); d) {
-		return d->typed_file()->empty();
+	auto const t = this->trail(p);
+	auto const f = t.file();
+	if(auto d = std::dynamic_pointer_cast<Directory const>(f); d) {
+		return d->empty();
 	}
 	if(auto r = std::dynamic_pointer_cast<RegularFile const>(f); r) {
 		return r->size() == 0;
 	}
-	throw fs::filesystem_error("cannot determine if file is empty", f->path(), std::make_error_code(std::errc::no_such_file_or_directory));
+	throw fs::filesystem_error("cannot determine if file is empty", t.path(), std::make_error_code(std::errc::no_such_file_or_directory));
+}
+
+std::shared_ptr<File> Vfs::lookup_(fs::path const& p, bool followed) const {
+	if(this->cache_) {
+		if(auto const r = this->cache_->find(p.native(), followed); r) {
+			if(r->error) {
+				std::rethrow_exception(r->error);
+			}
+			if(auto f = r->file.lock(); f) {
+				return f;
+			}
+		}
+	}
+
+	return this->resolve_(p, followed);
+}
+
+std::shared_ptr<File> Vfs::lookup_(fs::path const& p, bool followed, std::error_code& ec) const {
+	ec.clear();
+	if(this->cache_) {
+		if(auto const r = this->cache_->find(p.native(), followed); r) {
+			if(r->ec) {
+				ec = r->ec;
+				return nullptr;
+			}
+			if(auto f = r->file.lock(); f) {
+				return f;
+			}
+		}
+	}
+
+	try {
+		return this->resolve_(p, followed);
+	} catch(fs::filesystem_error const& err) {
+		ec = err.code();
+		return nullptr;
+	}
 }
 
+std::shared_ptr<File> Vfs::resolve_(fs::path const& p, bool followed) const {
+	if(!this->cache_) {
+		return followed
+		    ? this->trail_followed(p).file()
+		    : this->trail(p).file();
+	}
+
+	// Counters are read before each directory is looked into,
+	// so a change made while resolving makes the record stale rather than being missed.
+	ChangeWatch watch;
+	try {
+		auto t = Trail(this->from_of_(p), &watch);
+		t.walk(p);
+		if(followed) {
+			t.follow_chain();
+		}
+
+		auto f = t.file();
+		this->cache_->insert(p.native(), followed, f, std::move(watch));
+		return f;
+	} catch(fs::filesystem_error const& err) {
+		// Only the failures that can be fixed by creating a file are remembered.
+		auto const ec = err.code();
+		if(ec == std::errc::no_such_file_or_directory || ec == std::errc::not_a_directory) {
+			this->cache_->insert(p.native(), followed, ec, std::current_exception(), std::move(watch));
+		}
+
+		throw;
+	}
+}
+
+FileStatuses Vfs::status_many(std::span<fs::path const> ps) const {
+	FileStatuses rst;
+	rst.resize(ps.size());
+
+	fs::path                              dir_p;
+	std::shared_ptr<DirectoryEntry const> dir;
+	std::error_code                       dir_ec;
+	auto                                  has_dir = false;
+
+	for(std::size_t i = 0; i < ps.size(); ++i) {
+		auto const& p    = ps[i];
+		auto const  name = p.filename();
+
+		std::shared_ptr<File const> f;
+		std::error_code             ec;
+		if(!p.has_parent_path() || name.empty() || name == "." || name == "..") {
+			f = this->lookup_(p, true, ec);
+		} else {
+			if(!has_dir || p.parent_path() != dir_p) {
+				has_dir = true;
+				dir_p   = p.parent_path();
+				dir     = nullptr;
+				dir_ec.clear();
+				try {
+					dir = std::dynamic_pointer_cast<DirectoryEntry const>(this->navigate(dir_p)->follow_chain());
+					if(!dir) {
+						dir_ec = std::make_error_code(std::errc::not_a_directory);
+					}
+				} catch(fs::filesystem_error const& err) {
+					dir_ec = err.code();
+				}
+			}
+
+			if(dir_ec) {
+				ec = dir_ec;
+			} else {
+				try {
+					f = dir->navigate(name)->follow_chain()->file();
+				} catch(fs::filesystem_error const& err) {
+					ec = err.code();
+				}
+			}
+		}
+
+		if(f) {
+			// Attributes of OS files are read from the OS, which may fail, e.g. if the file was removed in the meantime.
+			try {
+				auto const type            = f->type();
+				auto const perms           = f->perms();
+				auto const last_write_time = f->last_write_time();
+				auto       size            = static_cast<std::uintmax_t>(-1);
+				if(auto const r = std::dynamic_pointer_cast<RegularFile const>(f); r) {
+					size = r->size();
+				}
+
+				rst.types[i]            = type;
+				rst.perms[i]            = perms;
+				rst.sizes[i]            = size;
+				rst.last_write_times[i] = last_write_time;
+				continue;
+			} catch(fs::filesystem_error const& err) {
+				ec = err.code();
+			}
+		}
+
+		if(ec == std::errc::no_such_file_or_directory || ec == std::errc::not_a_directory) {
+			rst.types[i] = fs::file_type::not_found;
+		} else {
+			rst.errors[i] = ec;
+		}
+	}
+
+	return rst;
+}
+
+namespace {
+
+// Fills the attributes from the file the cursor already holds instead of looking `p` up again.
+// Only the type is filled for files whose attributes are queried from their file system, e.g. `OsFile`,
+// so listing does not query each entry, nor fails on an entry that is dangling or removed in the meantime.
+void assign_entry_(directory_entry& entry, fs::path p, File const& f) {
+	if(dynamic_cast<VFile const*>(&f) == nullptr) {
+		auto type = fs::file_type::none;
+		try {
+			type = f.type();
+		} catch(fs::filesystem_error const&) {
+			// Left for the entry to query.
+		}
+
+		entry.assign(std::move(p), type);
+		return;
+	}
+
+	auto size = static_cast<std::uintmax_t>(-1);
+	if(auto const* r = dynamic_cast<RegularFile const*>(&f); r != nullptr) {
+		size = r->size();
+	}
+
+	entry.assign(std::move(p), fs::file_status(f.type(), f.perms()), size, f.last_write_time());
+}
+
+}  // namespace
+
 class Vfs::Cursor_: public Fs::Cursor {
    public:
 	Cursor_(Vfs const& fs, DirectoryEntry const& dir, std::filesystem::directory_options opts)
 	    : cursor_(dir.typed_file()->cursor())
-	    , opts_(opts) {
+	    , opts_(opts)
+	    , entry_(fs) {
 		if(cursor_->at_end()) {
 			return;
 		}
 
-		this->entry_ = directory_entry(fs, dir.path() / this->cursor_->name());
+		assign_entry_(this->entry_, dir.path() / this->cursor_->name(), *this->cursor_->file());
 	}
 
 	[[nodiscard]] directory_entry const& value() const override {
@@ -569,7 +907,8 @@ class Vfs::Cursor_: public Fs::Cursor {
 			return;
 		}
 
-		this->entry_.replace_filename(this->cursor_->name());
+		auto p = this->entry_.path();
+		assign_entry_(this->entry_, std::move(p.replace_filename(this->cursor_->name())), *this->cursor_->file());
 	}
 
    private:
@@ -584,13 +923,14 @@ class Vfs::RecursiveCursor_: public Fs::RecursiveCursor {
 	RecursiveCursor_(Vfs const& fs, DirectoryEntry const& dir, std::filesystem::directory_options opts)
 	    : cwd_(fs.cwd_)
 	    , cursors_({dir.typed_file()->cursor()})
-	    , opts_(opts) {
+	    , opts_(opts)
+	    , entry_(fs) {
 		if(this->cursors_.top()->at_end()) {
 			this->cursors_.pop();
 			return;
 		}
 
-		this->entry_ = directory_entry(fs, dir.path() / this->cursors_.top()->name());
+		assign_entry_(this->entry_, dir.path() / this->cursors_.top()->name(), *this->cursors_.top()->file());
 	}
 
 	[[nodiscard]] directory_entry const& value() const override {
@@ -621,7 +961,7 @@ class Vfs::RecursiveCursor_: public Fs::RecursiveCursor {
 				if(auto d = std::dynamic_pointer_cast<Directory const>(f); d && !d->empty()) {
 					auto c = d->cursor();
 
-					this->entry_.assign(this->entry_.path() / c->name());
+					assign_entry_(this->entry_, this->entry_.path() / c->name(), *c->file());
 					this->cursors_.push(std::move(c));
 					return;
 				}
@@ -632,18 +972,14 @@ class Vfs::RecursiveCursor_: public Fs::RecursiveCursor {
 				continue;
 			}
 
-			if(cnt_stepped_out == 0) {
-				this->entry_.replace_filename(cursor.name());
-			} else {
-				auto p = this->entry_.path();
-				for(std::size_t i = 0; i < cnt_stepped_out; ++i) {
-					p = p.parent_path();
-				}
-
-				p.replace_filename(cursor.name());
-				this->entry_.assign(p);
+			auto p = this->entry_.path();
+			for(std::size_t i = 0; i < cnt_stepped_out; ++i) {
+				p = p.parent_path();
 			}
 
+			p.replace_filename(cursor.name());
+			assign_entry_(this->entry_, std::move(p), *cursor.file());
+
 			break;
 		}
 	}
@@ -700,7 +1036,8 @@ class Vfs::RecursiveCursor_: public Fs::RecursiveCursor {
 				continue;
 			}
 
-			this->entry_.assign(p.replace_filename(cursor.name()));
+			p.replace_filename(cursor.name());
+			assign_entry_(this->entry_, p, *cursor.file());
 			break;
 		}
 	}
@@ -738,4 +1075,18 @@ std::shared_ptr<Fs> make_vfs(fs::path const& temp_dir) {
 	return std::make_shared<impl::Vfs>(temp_dir);
 }
 
+std::shared_ptr<Fs> make_vfs(fs::path const& temp_dir, VfsOptions const& opts) {
+	std::shared_ptr<impl::Directory> d;
+	if(opts.sorted_directories) {
+		d = std::make_shared<impl::SortedVDirectory>(impl::Directory::DefaultPerms, opts.concurrent);
+	} else {
+		d = std::make_shared<impl::VDirectory>(impl::Directory::DefaultPerms, opts.concurrent);
+	}
+
+	auto vfs = std::make_shared<impl::Vfs>(std::make_shared<impl::DirectoryEntry>("/", nullptr, std::move(d)), temp_dir);
+	vfs->apply(opts);
+
+	return vfs;
+}
+
 }  // namespace vfs
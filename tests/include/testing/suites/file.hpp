@@ -101,6 +101,29 @@ class TestFile {
 					CHECK(os->fail());
 				}
 			}
+
+			SECTION("::copy_from") {
+				auto const [foo, ok1] = sandbox->emplace_regular_file("foo");
+				auto const [bar, ok2] = sandbox->emplace_regular_file("bar");
+				REQUIRE(ok1);
+				REQUIRE(ok2);
+
+				std::string data;
+				while(data.size() < (3 << 20)) {
+					data += testing::QuoteA;
+				}
+
+				*foo->open_write() << data;
+				*bar->open_write() << data << data;
+				foo->perms(fs::perms::owner_read | fs::perms::owner_write);
+
+				bar->copy_from(*foo);
+				CHECK(data == testing::read_all(*bar->open_read()));
+				CHECK(foo->perms() == bar->perms());
+
+				*foo->open_write(std::ios_base::app) << testing::QuoteB;
+				CHECK(data.size() == bar->size());
+			}
 		}
 
 		SECTION("Directory") {
@@ -1,12 +1,20 @@
 #include <concepts>
 #include <cstddef>
+#include <filesystem>
+#include <future>
+#include <ios>
 #include <memory>
+#include <span>
 #include <string>
+#include <system_error>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <catch2/catch_template_test_macros.hpp>
 
+#include <vfs/directory_entry.hpp>
 #include <vfs/directory_iterator.hpp>
 #include <vfs/fs.hpp>
 
@@ -60,6 +68,123 @@ class TestFsBasic {
 				*fs->open_write("foo") << testing::QuoteA;
 				CHECK(testing::QuoteA == testing::read_all(*fs->open_read("foo")));
 			}
+
+			SECTION("writing an existing file") {
+				*fs->open_write("foo") << testing::QuoteA;
+				*fs->open_write("foo") << testing::QuoteB;
+				CHECK(testing::QuoteB == testing::read_all(*fs->open_read("foo")));
+			}
+		}
+
+		SECTION("::read_file, ::read_at, ::write_file") {
+			SECTION("reading a file that does not exist fails") {
+				CHECK_THROWS_AS(fs->read_file("foo"), filesystem_error);
+
+				std::error_code ec;
+				CHECK(fs->read_file("foo", ec).empty());
+				CHECK(ec == std::errc::no_such_file_or_directory);
+			}
+
+			SECTION("reading a directory fails") {
+				fs->create_directory("foo");
+				CHECK_THROWS_AS(fs->read_file("foo"), filesystem_error);
+			}
+
+			SECTION("writing a file creates a new file if the file does not exist") {
+				fs->write_file("foo", testing::QuoteA);
+				CHECK(testing::QuoteA == testing::read_all(*fs->open_read("foo")));
+				CHECK(testing::QuoteA == fs->read_file("foo"));
+			}
+
+			SECTION("writing an existing file replaces its contents") {
+				*fs->open_write("foo") << testing::QuoteA;
+				fs->write_file("foo", testing::QuoteB);
+				CHECK(testing::QuoteB == fs->read_file("foo"));
+			}
+
+			SECTION("writing with app appends") {
+				fs->write_file("foo", testing::QuoteA);
+				fs->write_file("foo", testing::QuoteB, std::ios_base::app);
+				CHECK(std::string(testing::QuoteA) + std::string(testing::QuoteB) == fs->read_file("foo"));
+			}
+
+			SECTION("writing in a directory that does not exist fails") {
+				CHECK_THROWS_AS(fs->write_file("foo/bar", testing::QuoteA), filesystem_error);
+			}
+
+			SECTION("read at an offset") {
+				std::string const content(testing::QuoteA);
+				fs->write_file("foo", content);
+
+				std::string buf(8, '\0');
+				CHECK(8 == fs->read_at("foo", 3, std::span(buf)));
+				CHECK(content.substr(3, 8) == buf);
+
+				CHECK(2 == fs->read_at("foo", content.size() - 2, std::span(buf)));
+				CHECK(content.substr(content.size() - 2) == buf.substr(0, 2));
+
+				CHECK(0 == fs->read_at("foo", content.size() + 1, std::span(buf)));
+			}
+		}
+
+		SECTION("::open_file") {
+			SECTION("opening a file that does not exist for reading fails") {
+				CHECK_THROWS_AS(fs->open_file("foo"), filesystem_error);
+				CHECK_THROWS_AS(fs->open_file("foo", std::ios_base::in), filesystem_error);
+			}
+
+			SECTION("opening a directory fails") {
+				fs->create_directory("foo");
+				CHECK_THROWS_AS(fs->open_file("foo"), filesystem_error);
+				CHECK_THROWS_AS(fs->open_file("foo", std::ios_base::in | std::ios_base::out), filesystem_error);
+			}
+
+			SECTION("opening for writing creates a new file if the file does not exist") {
+				auto const h = fs->open_file("foo", std::ios_base::out);
+				CHECK(fs->exists("foo"));
+				CHECK(0 == h->size());
+			}
+
+			SECTION("read-only handle fails to write") {
+				fs->write_file("foo", testing::QuoteA);
+
+				auto const h = fs->open_file("foo");
+				CHECK_THROWS_AS(h->pwrite("bar", 0), filesystem_error);
+				CHECK_THROWS_AS(h->truncate(0), filesystem_error);
+				CHECK(testing::QuoteA == fs->read_file("foo"));
+			}
+
+			SECTION("writes in place") {
+				std::string content(testing::QuoteA);
+				fs->write_file("foo", content);
+
+				auto const h = fs->open_file("foo", std::ios_base::in | std::ios_base::out);
+				REQUIRE(content.size() == h->size());
+
+				h->pwrite("bar", 6);
+				content.replace(6, 3, "bar");
+				CHECK(content == fs->read_file("foo"));
+
+				std::string buf(3, '\0');
+				CHECK(3 == h->pread(buf, 6));
+				CHECK("bar" == buf);
+
+				h->pwrite("baz", content.size() + 1);
+				CHECK(content + '\0' + "baz" == fs->read_file("foo"));
+
+				h->truncate(5);
+				h->sync();
+				CHECK(5 == h->size());
+				CHECK(content.substr(0, 5) == fs->read_file("foo"));
+			}
+
+			SECTION("opening with trunc truncates the file") {
+				fs->write_file("foo", testing::QuoteA);
+
+				auto const h = fs->open_file("foo", std::ios_base::out | std::ios_base::trunc);
+				CHECK(0 == h->size());
+				CHECK(fs->read_file("foo").empty());
+			}
 		}
 
 		SECTION("::change_root") {
@@ -660,12 +785,107 @@ class TestFsBasic {
 			}
 		}
 
+		SECTION("::status_many") {
+			fs->write_file("foo", testing::QuoteA);
+			fs->create_directories("bar/baz");
+			fs->write_file("bar/qux", testing::QuoteB);
+			fs->create_symlink("qux", "bar/link");
+
+			std::vector<std::filesystem::path> const ps{"foo", "bar", "bar/baz", "bar/qux", "bar/link", "bar/nothing", "nothing/foo", "foo/bar", "/"};
+
+			auto const rst = fs->status_many(ps);
+			REQUIRE(ps.size() == rst.size());
+			for(std::size_t i = 0; i < ps.size(); ++i) {
+				CHECK(!rst.errors[i]);
+
+				auto const s = fs->status(ps[i]);
+				CHECK(s.type() == rst.types[i]);
+				if(!fs->exists(s)) {
+					continue;
+				}
+
+				CHECK(s.permissions() == rst.perms[i]);
+				CHECK(fs->last_write_time(ps[i]) == rst.last_write_times[i]);
+				if(fs->is_regular_file(s)) {
+					CHECK(fs->file_size(ps[i]) == rst.sizes[i]);
+				} else {
+					CHECK(static_cast<std::uintmax_t>(-1) == rst.sizes[i]);
+				}
+			}
+
+			CHECK(testing::QuoteB.size() == rst.sizes[4]);
+		}
+
+		SECTION("::map_read") {
+			fs->write_file("foo", testing::QuoteA);
+			CHECK(testing::QuoteA == testing::read_all(*fs->map_read("foo")));
+		}
+
+		SECTION("::async_read_file") {
+			fs->write_file("foo", testing::QuoteA);
+
+			std::promise<std::pair<std::error_code, std::string>> done;
+			fs->async_read_file("foo", [&](std::error_code ec, std::string data) {
+				done.set_value({ec, std::move(data)});
+			});
+
+			auto const [ec, data] = done.get_future().get();
+			CHECK(!ec);
+			CHECK(testing::QuoteA == data);
+
+			std::promise<std::error_code> failed;
+			fs->async_read_file("bar", [&](std::error_code ec, std::string) {
+				failed.set_value(ec);
+			});
+			CHECK(std::errc::no_such_file_or_directory == failed.get_future().get());
+		}
+
+		SECTION("::async_write_file") {
+			std::promise<std::error_code> done;
+			fs->async_write_file("foo", std::string(testing::QuoteA), std::ios_base::out, [&](std::error_code ec) {
+				done.set_value(ec);
+			});
+			CHECK(!done.get_future().get());
+			CHECK(testing::QuoteA == fs->read_file("foo"));
+
+			std::promise<std::error_code> appended;
+			fs->async_write_file("foo", std::string(testing::QuoteB), std::ios_base::app, [&](std::error_code ec) {
+				appended.set_value(ec);
+			});
+			CHECK(!appended.get_future().get());
+			CHECK(std::string(testing::QuoteA) + std::string(testing::QuoteB) == fs->read_file("foo"));
+		}
+
+		SECTION("::async_status") {
+			fs->create_directory("foo");
+
+			std::promise<std::pair<std::error_code, std::filesystem::file_status>> done;
+			fs->async_status("foo", [&](std::error_code ec, std::filesystem::file_status s) {
+				done.set_value({ec, s});
+			});
+
+			auto const [ec, s] = done.get_future().get();
+			CHECK(!ec);
+			CHECK(fs->is_directory(s));
+		}
+
+		SECTION("::async_copy") {
+			fs->write_file("foo", testing::QuoteA);
+
+			std::promise<std::error_code> done;
+			fs->async_copy("foo", "bar", std::filesystem::copy_options::none, [&](std::error_code ec) {
+				done.set_value(ec);
+			});
+			CHECK(!done.get_future().get());
+			CHECK(testing::QuoteA == fs->read_file("bar"));
+		}
+
 		SECTION("::iterate_directory") {
 			fs->open_write("foo");
 			fs->open_write("bar");
 
 			std::unordered_set<std::string> filenames;
-			for(auto const entry: fs->iterate_directory(".")) {
+			for(auto const& entry: fs->iterate_directory(".")) {
 				CHECK(entry.is_regular_file());
 				filenames.insert(entry.path().filename());
 			}
@@ -673,6 +893,37 @@ class TestFsBasic {
 			CHECK(std::unordered_set<std::string>{"foo", "bar"} == filenames);
 		}
 
+		SECTION("::iterate_directory with attributes") {
+			fs->write_file("foo", testing::QuoteA);
+			fs->create_directory("bar");
+			fs->create_symlink("foo", "baz");
+			fs->create_symlink("nothing", "qux");
+
+			std::size_t cnt = 0;
+			for(auto const& entry: fs->iterate_directory(".")) {
+				++cnt;
+
+				auto const p = entry.path();
+				CHECK(fs->exists(p) == entry.exists());
+				CHECK(fs->symlink_status(p).type() == entry.symlink_status().type());
+				CHECK(fs->symlink_status(p).permissions() == entry.symlink_status().permissions());
+				CHECK(fs->status(p).type() == entry.status().type());
+				if(p.filename() == "qux") {
+					// Dangling.
+					CHECK(!entry.exists());
+					continue;
+				}
+
+				CHECK(fs->last_write_time(p) == entry.last_write_time());
+				if(p.filename() != "bar") {
+					CHECK(testing::QuoteA.size() == entry.file_size());
+				}
+			}
+			CHECK(4 == cnt);
+
+			CHECK(!vfs::directory_entry(*fs, "qux").exists());
+		}
+
 		SECTION("::iterate_directory_recursively") {
 			auto const check =
 			    [&fs](vfs::recursive_directory_iterator it, std::unordered_map<int, std::unordered_set<std::string>> const& expected_list) {
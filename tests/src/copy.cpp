@@ -242,3 +242,114 @@ class CopyFromVfsToVfs: public TestCopyFixture {
 };
 
 METHOD_AS_TEST_CASE(TestCopy<CopyFromVfsToVfs>::test, "Copy from Vfs to Vfs");
+
+class CopyFromVfsToVfsInParallel: public TestCopyFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make_src_fs() override {
+		return vfs::make_vfs("/tmp", vfs::VfsOptions{.copy_concurrency = 4});
+	}
+
+	std::shared_ptr<vfs::Fs> make_dst_fs() override {
+		return vfs::make_mem_fs();
+	}
+};
+
+METHOD_AS_TEST_CASE(TestCopy<CopyFromVfsToVfsInParallel>::test, "Copy from Vfs to Vfs in parallel");
+
+class CopyFromVfsToOsFsInParallel: public TestCopyFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make_src_fs() override {
+		return vfs::make_mem_fs("/tmp", vfs::VfsOptions{.copy_concurrency = 4});
+	}
+
+	std::shared_ptr<vfs::Fs> make_dst_fs() override {
+		return vfs::make_os_fs();
+	}
+};
+
+METHOD_AS_TEST_CASE(TestCopy<CopyFromVfsToOsFsInParallel>::test, "Copy from Vfs to OsFs in parallel");
+
+TEST_CASE("Copy within an OsFs mounted on Vfs") {
+	auto const os  = testing::cd_temp_dir(*vfs::make_os_fs());
+	auto const src = vfs::make_vfs();
+	src->create_directory("/os");
+	src->mount("/os", *os, ".");
+
+	os->create_directories("foo/bar");
+	os->create_directory("qux");
+	*os->open_write("foo/dog") << "woof";
+	os->create_symlink("./dog", "foo/cat");
+
+	SECTION("without option") {
+		src->copy("/os/foo", "/os/qux/baz");
+		CHECK(src->is_regular_file("/os/qux/baz/dog"));
+		CHECK(not src->is_directory("/os/qux/baz/bar"));
+		CHECK(not src->exists("/os/qux/baz/cat"));
+	}
+
+	SECTION("with option recursive") {
+		src->copy("/os/foo", "/os/qux/baz", fs::copy_options::recursive);
+		CHECK(src->is_regular_file("/os/qux/baz/dog"));
+		CHECK(src->is_directory("/os/qux/baz/bar"));
+		CHECK(not src->exists("/os/qux/baz/cat"));
+	}
+
+	SECTION("with option recursive and copy_symlinks") {
+		src->copy("/os/foo", "/os/qux/baz", fs::copy_options::recursive | fs::copy_options::copy_symlinks);
+		CHECK(src->is_regular_file("/os/qux/baz/dog"));
+		CHECK(src->is_symlink("/os/qux/baz/cat"));
+	}
+}
+
+TEST_CASE("Copy in parallel") {
+	auto const src = testing::cd_temp_dir(*vfs::make_vfs("/tmp", vfs::VfsOptions{.copy_concurrency = 4}));
+	auto const dst = testing::cd_temp_dir(*vfs::make_os_fs());
+
+	// /
+	// + foo/
+	//   + 0/
+	//     + 0, 1, ..., 15
+	//   + 1/
+	//   ...
+	//   + 7/
+	for(int i = 0; i < 8; ++i) {
+		auto const d = fs::path("foo") / std::to_string(i);
+		src->create_directories(d);
+		for(int j = 0; j < 16; ++j) {
+			*src->open_write(d / std::to_string(j)) << i << '/' << j;
+		}
+	}
+
+	SECTION("copies every file") {
+		src->copy("foo", *dst, "foo", fs::copy_options::recursive);
+		for(int i = 0; i < 8; ++i) {
+			for(int j = 0; j < 16; ++j) {
+				auto const p = fs::path("foo") / std::to_string(i) / std::to_string(j);
+				REQUIRE(dst->is_regular_file(p));
+				CHECK((std::to_string(i) + '/' + std::to_string(j)) == testing::read_all(*dst->open_read(p)));
+			}
+		}
+	}
+
+	SECTION("copies files visited before an error") {
+		dst->create_directories("foo/7");
+		*dst->open_write("foo/7/0") << "existing";
+
+		std::error_code ec;
+		src->copy("foo", *dst, "foo", fs::copy_options::recursive, ec);
+		CHECK(std::errc::file_exists == ec);
+		CHECK("existing" == testing::read_all(*dst->open_read("foo/7/0")));
+
+		// Files created before the error are not left empty.
+		for(int i = 0; i < 7; ++i) {
+			for(int j = 0; j < 16; ++j) {
+				auto const p = fs::path("foo") / std::to_string(i) / std::to_string(j);
+				if(!dst->exists(p)) {
+					continue;
+				}
+
+				CHECK((std::to_string(i) + '/' + std::to_string(j)) == testing::read_all(*dst->open_read(p)));
+			}
+		}
+	}
+}
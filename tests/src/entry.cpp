@@ -146,3 +146,55 @@ TEST_CASE("SymlinkEntry") {
 		CHECK(bar->holds_same_file_with(*root->navigate("/foobar/../bar")));
 	}
 }
+
+TEST_CASE("Trail") {
+	// /
+	// + foo/
+	//   + bar
+	//   + baz -> ./bar
+	//   + loop -> ./loop
+	// + qux -> /foo
+	auto root = vfs::impl::DirectoryEntry::make_root();
+	auto foo  = std::make_shared<vfs::impl::DirectoryEntry>("foo", root, root->emplace_directory("foo"));
+	auto bar  = std::make_shared<vfs::impl::RegularFileEntry>("bar", foo, foo->emplace_regular_file("bar"));
+	foo->emplace_symlink("baz", "./bar");
+	foo->emplace_symlink("loop", "./loop");
+	root->emplace_symlink("qux", "/foo");
+
+	SECTION("::walk") {
+		auto t = vfs::impl::Trail(root);
+		t.walk("qux/baz");
+		CHECK("/foo/baz" == t.path());
+		CHECK(vfs::impl::Symlink::Type == t.file()->type());
+
+		t.follow_chain();
+		CHECK("/foo/bar" == t.path());
+		CHECK(bar->holds(*t.file()));
+		CHECK(bar->holds_same_file_with(*t.entry()));
+		CHECK("/foo/bar" == t.entry()->path());
+	}
+
+	SECTION("::walk stops at the component that cannot be walked") {
+		std::filesystem::path p = "foo/bar/baz";
+
+		auto t  = vfs::impl::Trail(root);
+		auto it = p.begin();
+		CHECK_THROWS_AS(t.walk(it, p.end()), std::filesystem::filesystem_error);
+		CHECK("baz" == *it);
+		CHECK("/foo/bar" == t.path());
+	}
+
+	SECTION("::follow_chain fails on circular symlinks") {
+		auto t = vfs::impl::Trail(root);
+		t.walk("foo/loop");
+
+		std::error_code ec;
+		try {
+			t.follow_chain();
+		} catch(std::filesystem::filesystem_error const& err) {
+			ec = err.code();
+		}
+		CHECK(std::errc::too_many_symbolic_link_levels == ec);
+		CHECK("/foo/loop" == t.path());
+	}
+}
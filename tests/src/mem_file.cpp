@@ -1,9 +1,18 @@
+#include <atomic>
+#include <cstddef>
+#include <ios>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
 
 #include <vfs/impl/mem_file.hpp>
 
+#include "testing.hpp"
 #include "testing/suites/file.hpp"
 
 class TestMemFile: public testing::suites::TestFileFixture {
@@ -14,3 +23,248 @@ class TestMemFile: public testing::suites::TestFileFixture {
 };
 
 METHOD_AS_TEST_CASE(testing::suites::TestFile<TestMemFile>::test, "MemFile");
+
+TEST_CASE("MemRegularFile") {
+	auto f = std::make_shared<vfs::impl::MemRegularFile>();
+	*f->open_write(std::ios_base::out) << "Lorem ipsum";
+
+	SECTION("::open_read reads a snapshot") {
+		auto r = f->open_read(std::ios_base::in);
+
+		SECTION("trunc") {
+			*f->open_write(std::ios_base::out) << "dolor";
+		}
+		SECTION("app") {
+			*f->open_write(std::ios_base::app) << " dolor";
+		}
+		SECTION("resize") {
+			f->resize(3);
+		}
+
+		CHECK("Lorem ipsum" == testing::read_all(*r));
+	}
+
+	SECTION("::open_write publishes on flush") {
+		auto w = f->open_write(std::ios_base::out);
+		*w << "dolor";
+		CHECK("Lorem ipsum" == testing::read_all(*f->open_read(std::ios_base::in)));
+
+		w->flush();
+		CHECK("dolor" == testing::read_all(*f->open_read(std::ios_base::in)));
+
+		*w << " sit amet";
+		CHECK("dolor" == testing::read_all(*f->open_read(std::ios_base::in)));
+
+		w.reset();
+		CHECK("dolor sit amet" == testing::read_all(*f->open_read(std::ios_base::in)));
+	}
+
+	SECTION("::open_write writes large data") {
+		std::string const data(100'000, 'x');
+		*f->open_write(std::ios_base::app) << data;
+		CHECK(std::string("Lorem ipsum") + data == testing::read_all(*f->open_read(std::ios_base::in)));
+	}
+
+	SECTION("::open_read seeks") {
+		auto r = f->open_read(std::ios_base::in);
+
+		r->seekg(6);
+		CHECK("ipsum" == testing::read_all(*r));
+
+		r->clear();
+		r->seekg(-5, std::ios_base::end);
+		CHECK(6 == r->tellg());
+
+		std::string word;
+		*r >> word;
+		CHECK("ipsum" == word);
+
+		r->clear();
+		r->seekg(0);
+		CHECK("Lorem ipsum" == std::string(std::istreambuf_iterator<char>(*r), {}));
+	}
+
+	SECTION("::open_read starts at the end with ate") {
+		auto r = f->open_read(std::ios_base::in | std::ios_base::ate);
+		CHECK(11 == r->tellg());
+		CHECK("" == testing::read_all(*r));
+
+		r->clear();
+		r->seekg(-5, std::ios_base::cur);
+		CHECK("ipsum" == testing::read_all(*r));
+	}
+}
+
+TEST_CASE("PagedBuffer") {
+	constexpr auto PageSize = vfs::impl::PagedBuffer::PageSize;
+
+	std::string data;
+	for(std::size_t i = 0; data.size() < PageSize * 2 + 100; ++i) {
+		data += std::to_string(i);
+	}
+
+	vfs::impl::PagedBuffer b;
+	b.append(data);
+	REQUIRE(data.size() == b.size());
+	REQUIRE(3 == b.page_count());
+	CHECK(PageSize == b.page(0).size());
+	CHECK(PageSize == b.page(1).size());
+	CHECK(data.substr(PageSize) == std::string(b.page(1)) + std::string(b.page(2)));
+
+	SECTION("::resize") {
+		b.resize(PageSize + 1);
+		CHECK(2 == b.page_count());
+		CHECK(data.substr(PageSize, 1) == b.page(1));
+
+		b.resize(PageSize + 3);
+		CHECK((data.substr(PageSize, 1) + std::string(2, '\0')) == b.page(1));
+	}
+
+	SECTION("copies share pages until written") {
+		auto c = b;
+		c.append("foo");
+		c.resize(1);
+
+		CHECK(data.size() == b.size());
+		CHECK(data.substr(PageSize * 2) == b.page(2));
+		CHECK(data.substr(0, 1) == c.page(0));
+	}
+
+	SECTION("::append shares pages at a page boundary") {
+		vfs::impl::PagedBuffer c;
+		c.append(data.substr(0, PageSize));
+		c.append(b);
+
+		REQUIRE(PageSize + data.size() == c.size());
+		CHECK(b.page(1).data() == c.page(2).data());
+	}
+
+	SECTION("::write overwrites across pages without touching shared pages") {
+		auto c = b;
+		c.write(PageSize - 1, "foo");
+
+		auto expected = data;
+		expected.replace(PageSize - 1, 3, "foo");
+		CHECK(data.size() == c.size());
+		CHECK(expected.substr(0, PageSize) == c.page(0));
+		CHECK(expected.substr(PageSize, PageSize) == c.page(1));
+		CHECK(b.page(2).data() == c.page(2).data());
+		CHECK(data.substr(0, PageSize) == b.page(0));
+	}
+
+	SECTION("copies append full pages without copying the others") {
+		auto const tail = data.size() % PageSize;
+
+		auto c = b;
+		auto d = b;
+		c.append(std::string(PageSize, 'c'));
+		d.append(std::string(PageSize, 'd'));
+
+		REQUIRE(4 == c.page_count());
+		REQUIRE(4 == d.page_count());
+		CHECK(b.page(1).data() == c.page(1).data());
+		CHECK(b.page(1).data() == d.page(1).data());
+		CHECK(data.substr(PageSize * 2) + std::string(PageSize - tail, 'c') == c.page(2));
+		CHECK(data.substr(PageSize * 2) + std::string(PageSize - tail, 'd') == d.page(2));
+		CHECK(std::string(tail, 'c') == c.page(3));
+		CHECK(std::string(tail, 'd') == d.page(3));
+		CHECK(data.substr(PageSize * 2) == b.page(2));
+
+		c.resize(PageSize + 1);
+		c.append("foo");
+		CHECK(data.substr(PageSize, 1) + "foo" == c.page(1));
+		CHECK(data.substr(PageSize, PageSize) == b.page(1));
+	}
+
+	SECTION("::write beyond the end fills the gap with zeros") {
+		b.write(data.size() + 2, "foo");
+		CHECK(data.size() + 5 == b.size());
+
+		std::string tail(5, 'x');
+		CHECK(5 == b.read(data.size(), tail));
+		CHECK((std::string(2, '\0') + "foo") == tail);
+	}
+}
+
+TEST_CASE("MemRegularFile with pages") {
+	constexpr auto PageSize = vfs::impl::PagedBuffer::PageSize;
+
+	std::string const data = std::string(PageSize, 'a') + std::string(PageSize, 'b') + "c";
+
+	auto f = std::make_shared<vfs::impl::MemRegularFile>();
+	*f->open_write(std::ios_base::out) << data;
+	REQUIRE(data.size() == f->size());
+	REQUIRE(data == testing::read_all(*f->open_read(std::ios_base::in)));
+
+	SECTION("::open_read seeks across pages") {
+		auto r = f->open_read(std::ios_base::in);
+
+		r->seekg(PageSize * 2 - 1);
+		CHECK("bc" == testing::read_all(*r));
+
+		r->clear();
+		r->seekg(PageSize);
+		CHECK('b' == r->get());
+		CHECK(PageSize + 1 == r->tellg());
+
+		r->seekg(-1, std::ios_base::end);
+		CHECK("c" == testing::read_all(*r));
+	}
+
+	SECTION("::copy_from shares the data") {
+		auto g = std::make_shared<vfs::impl::MemRegularFile>();
+		g->copy_from(*f);
+		CHECK(data == testing::read_all(*g->open_read(std::ios_base::in)));
+
+		*g->open_write(std::ios_base::app) << "d";
+		CHECK(data + "d" == testing::read_all(*g->open_read(std::ios_base::in)));
+		CHECK(data == testing::read_all(*f->open_read(std::ios_base::in)));
+	}
+
+	SECTION("copy constructor shares the data") {
+		auto g = std::make_shared<vfs::impl::MemRegularFile>(*f);
+		g->resize(1);
+		CHECK("a" == testing::read_all(*g->open_read(std::ios_base::in)));
+		CHECK(data == testing::read_all(*f->open_read(std::ios_base::in)));
+	}
+}
+
+TEST_CASE("MemRegularFile read while written") {
+	auto const f = std::make_shared<vfs::impl::MemRegularFile>();
+	*f->open_write(std::ios_base::out) << std::string(100, 'a');
+
+	constexpr int NumReaders = 4;
+	constexpr int NumWrites  = 200;
+
+	std::atomic<bool> done = false;
+	std::atomic<int>  torn = 0;
+
+	std::vector<std::thread> readers;
+	for(int i = 0; i < NumReaders; ++i) {
+		readers.emplace_back([&] {
+			while(!done.load()) {
+				// Every version consists of one character.
+				auto const content = testing::read_all(*f->open_read(std::ios_base::in));
+				if(content.empty() || content.find_first_not_of(content[0]) != std::string::npos) {
+					++torn;
+				}
+			}
+		});
+	}
+
+	for(int i = 0; i < NumWrites; ++i) {
+		auto const c = static_cast<char>('a' + (i / 2) % 26);
+		if(i % 2 == 0) {
+			*f->open_write(std::ios_base::trunc) << std::string(100 + i, c);
+		} else {
+			*f->open_write(std::ios_base::app) << std::string(vfs::impl::PagedBuffer::PageSize, c);
+		}
+	}
+
+	done = true;
+	for(auto& reader: readers) {
+		reader.join();
+	}
+
+	CHECK(0 == torn);
+}
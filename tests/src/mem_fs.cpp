@@ -1,11 +1,21 @@
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
 
 #include <vfs/fs.hpp>
 
+#include "testing.hpp"
 #include "testing/suites/fs.hpp"
 
+namespace fs = std::filesystem;
+
 class TestMemFs: public testing::suites::TestFsFixture {
    public:
 	std::shared_ptr<vfs::Fs> make() override {
@@ -27,3 +37,73 @@ class TestChRootedVfs: public testing::suites::TestFsFixture {
 };
 
 METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestChRootedVfs>::test, "MemFs with chroot");
+
+class TestCachedMemFs: public testing::suites::TestFsFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make() override {
+		return vfs::make_mem_fs("/tmp", {.cache_lookups = true});
+	}
+};
+
+METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestCachedMemFs>::test, "MemFs with lookup cache");
+
+class TestSortedMemFs: public testing::suites::TestFsFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make() override {
+		return vfs::make_mem_fs("/tmp", {.sorted_directories = true});
+	}
+};
+
+METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestSortedMemFs>::test, "MemFs with sorted directories");
+
+class TestConcurrentMemFs: public testing::suites::TestFsFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make() override {
+		return vfs::make_mem_fs("/tmp", {.cache_lookups = true, .concurrent = true});
+	}
+};
+
+METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestConcurrentMemFs>::test, "MemFs with concurrent");
+
+TEST_CASE("MemFs used by multiple threads") {
+	auto const fs = vfs::make_mem_fs("/tmp", {.cache_lookups = true, .concurrent = true});
+	fs->create_directories("/a");
+	fs->create_directories("/b");
+
+	constexpr int NumThreads = 8;
+	constexpr int NumFiles   = 64;
+
+	// Catch2 assertions are not thread-safe, so failures are counted and checked afterward.
+	std::atomic<int> missing = 0;
+
+	std::vector<std::thread> threads;
+	for(int i = 0; i < NumThreads; ++i) {
+		threads.emplace_back([&fs, &missing, i] {
+			auto const dir = fs::path("/a") / std::to_string(i);
+			fs->create_directory(dir);
+			for(int j = 0; j < NumFiles; ++j) {
+				auto const name = std::to_string(j);
+				*fs->open_write(dir / name) << i;
+				if(!fs->exists("/a")) {
+					++missing;
+				}
+				fs->rename(dir / name, fs::path("/b") / (std::to_string(i) + "-" + name));
+			}
+		});
+	}
+	for(auto& thread: threads) {
+		thread.join();
+	}
+	CHECK(0 == missing);
+
+	std::size_t cnt = 0;
+	for(auto const& entry: fs->iterate_directory("/b")) {
+		(void)entry;
+		++cnt;
+	}
+	CHECK(NumThreads * NumFiles == cnt);
+	for(int i = 0; i < NumThreads; ++i) {
+		CHECK(fs->is_empty(fs::path("/a") / std::to_string(i)));
+		CHECK(std::to_string(i) == testing::read_all(*fs->open_read(fs::path("/b") / (std::to_string(i) + "-0"))));
+	}
+}
@@ -135,6 +135,23 @@ class TestMount {
 				CHECK(testing::QuoteB == testing::read_all(*rhs->open_read("b/bar/y")));
 			}
 
+			SECTION("copy a subtree that contains a mount point") {
+				using opts = fs::copy_options;
+
+				lhs->create_directories("c/d");
+				*lhs->open_write("c/d/z") << testing::QuoteA;
+				lhs->create_directory("c/m");
+				lhs->mount("c/m", *rhs, "b");
+
+				lhs->copy("c", "e", opts::recursive);
+				CHECK(testing::QuoteA == testing::read_all(*lhs->open_read("e/d/z")));
+				CHECK(lhs->is_directory("e/m/foo"));
+				CHECK(lhs->is_directory("e/m/bar"));
+
+				*lhs->open_write("e/m/w") << testing::QuoteB;
+				CHECK(not rhs->exists("b/w"));
+			}
+
 			SECTION("rename to") {
 				rhs->remove_all("b/foo");
 				rhs->remove_all("b/bar");
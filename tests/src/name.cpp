@@ -0,0 +1,86 @@
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vfs/impl/name.hpp>
+
+TEST_CASE("Name") {
+	using vfs::impl::Name;
+
+	SECTION("equal names share a string") {
+		auto const a = Name("foo");
+		auto const b = Name(std::string("foo"));
+		CHECK(a == b);
+		CHECK(&a.str() == &b.str());
+		CHECK(Name::Hash{}(a) == Name::Hash{}(b));
+
+		auto const c = Name("bar");
+		CHECK(not(a == c));
+	}
+
+	SECTION("compared with strings by value") {
+		auto const a = Name("foo");
+		CHECK(a == std::string_view("foo"));
+		CHECK(not(a == std::string_view("bar")));
+		CHECK(Name::Hash{}(a) == Name::Hash{}(std::string_view("foo")));
+	}
+
+	SECTION("is interned again after released") {
+		{
+			auto const a = Name("released");
+		}
+
+		auto const a = Name("released");
+		CHECK("released" == a.str());
+		CHECK(a == Name("released"));
+	}
+
+	SECTION("searched by strings in sets") {
+		std::unordered_set<Name, Name::Hash, std::equal_to<>> names;
+		names.emplace("foo");
+		names.emplace("bar");
+		names.emplace("foo");
+		CHECK(2 == names.size());
+		CHECK(names.contains(std::string("foo")));
+		CHECK(not names.contains(std::string("baz")));
+	}
+
+	SECTION("copies and moves share the string") {
+		auto a = Name("foo");
+		auto b = a;
+		CHECK(&a.str() == &b.str());
+
+		auto const c = std::move(a);
+		CHECK(&b.str() == &c.str());
+
+		a = c;
+		CHECK(&a.str() == &c.str());
+	}
+
+	SECTION("interned and released by many threads") {
+		std::atomic<std::size_t> wrong = 0;
+		{
+			std::vector<std::jthread> workers;
+			for(std::size_t i = 0; i < 8; ++i) {
+				workers.emplace_back([&] {
+					for(std::size_t j = 0; j < 10000; ++j) {
+						auto const s    = std::to_string(j % 16);
+						auto const name = Name(s);
+						if(name.str() != s) {
+							wrong.fetch_add(1);
+						}
+					}
+				});
+			}
+		}
+
+		CHECK(0 == wrong.load());
+	}
+}
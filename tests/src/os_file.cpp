@@ -1,9 +1,19 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <ios>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
 
+#include <vfs/impl/mem_file.hpp>
 #include <vfs/impl/os_file.hpp>
 
+#include "testing.hpp"
 #include "testing/suites/file.hpp"
 
 class TestOsFile: public testing::suites::TestFileFixture {
@@ -14,3 +24,179 @@ class TestOsFile: public testing::suites::TestFileFixture {
 };
 
 METHOD_AS_TEST_CASE(testing::suites::TestFile<TestOsFile>::test, "OsFile");
+
+TEST_CASE("OsRegularFile::copy_from") {
+	auto const sandbox = std::make_shared<vfs::impl::TempDirectory>();
+	auto const [os_f, ok] = sandbox->emplace_regular_file("foo");
+	REQUIRE(ok);
+
+	std::shared_ptr<vfs::impl::RegularFile> const mem_f = std::make_shared<vfs::impl::MemRegularFile>();
+
+	SECTION("from a file on a different backend") {
+		*mem_f->open_write() << testing::QuoteA;
+		os_f->copy_from(*mem_f);
+		CHECK(testing::QuoteA == testing::read_all(*os_f->open_read()));
+	}
+
+	SECTION("to a file on a different backend") {
+		*os_f->open_write() << testing::QuoteA;
+		mem_f->copy_from(*os_f);
+		CHECK(testing::QuoteA == testing::read_all(*mem_f->open_read()));
+	}
+
+	SECTION("fails if the source does not exist") {
+		auto const [bar, ok] = sandbox->emplace_regular_file("bar");
+		REQUIRE(ok);
+		REQUIRE(sandbox->unlink("bar"));
+
+		CHECK_THROWS_AS(os_f->copy_from(*bar), std::filesystem::filesystem_error);
+	}
+}
+
+TEST_CASE("OsRegularFile::map_read") {
+	auto const sandbox = std::make_shared<vfs::impl::TempDirectory>();
+	auto const [f, ok] = sandbox->emplace_regular_file("foo");
+	REQUIRE(ok);
+
+	std::string content;
+	while(content.size() < vfs::impl::MinMappedReadSize) {
+		content += testing::QuoteA;
+	}
+	*f->open_write() << content;
+
+	SECTION("reads whole contents") {
+		CHECK(content == testing::read_all(*f->map_read()));
+	}
+
+	SECTION("seeks") {
+		auto const is = f->map_read();
+		is->seekg(-3, std::ios_base::end);
+		CHECK(static_cast<std::streamoff>(content.size() - 3) == is->tellg());
+		CHECK(content.substr(content.size() - 3) == testing::read_all(*is));
+
+		is->clear();
+		is->seekg(42);
+		CHECK(content[42] == is->get());
+	}
+
+	SECTION("open_read starts at the end with ate") {
+		auto const is = f->open_read(std::ios_base::ate);
+		CHECK(static_cast<std::streamoff>(content.size()) == is->tellg());
+	}
+}
+
+TEST_CASE("TempRegularFile") {
+	auto const f = std::make_shared<vfs::impl::TempRegularFile>();
+	auto const g = std::make_shared<vfs::impl::TempRegularFile>();
+	CHECK(f->path() != g->path());
+	CHECK(0 == f->size());
+
+	*f->open_write(std::ios_base::out) << testing::QuoteA;
+	*g->open_write(std::ios_base::out) << testing::QuoteB;
+	CHECK(testing::QuoteA == testing::read_all(*f->open_read(std::ios_base::in)));
+	CHECK(testing::QuoteB == testing::read_all(*g->open_read(std::ios_base::in)));
+
+	auto const h = f->open_handle(std::ios_base::in | std::ios_base::out);
+	h->pwrite("foo", 0);
+	CHECK(testing::QuoteA.size() == h->size());
+	CHECK("foo" == testing::read_all(*f->open_read(std::ios_base::in)).substr(0, 3));
+
+	auto const moved = vfs::impl::TempRegularFile(std::move(*g));
+	CHECK(testing::QuoteB == testing::read_all(*moved.open_read(std::ios_base::in)));
+
+	// Named so it holds no descriptor while it lives.
+	auto const p = moved.path();
+	CHECK(std::filesystem::temp_directory_path() / "vfs" == p.parent_path());
+	CHECK(std::filesystem::is_regular_file(p));
+
+	std::filesystem::path q;
+	{
+		auto const t = vfs::impl::TempRegularFile();
+		q            = t.path();
+		CHECK(std::filesystem::exists(q));
+	}
+	CHECK(not std::filesystem::exists(q));
+}
+
+TEST_CASE("TempDirectory") {
+	auto const d = std::make_shared<vfs::impl::TempDirectory>();
+	auto const e = std::make_shared<vfs::impl::TempDirectory>();
+	CHECK(d->path() != e->path());
+	CHECK(std::filesystem::is_directory(d->path()));
+	CHECK(std::filesystem::is_empty(d->path()));
+}
+
+TEST_CASE("OsDirectory::cursor") {
+	auto const sandbox = std::make_shared<vfs::impl::TempDirectory>();
+	sandbox->emplace_regular_file("foo");
+	sandbox->emplace_directory("bar");
+	sandbox->emplace_symlink("baz", "foo");
+
+	std::unordered_map<std::string, std::filesystem::file_type> types;
+	for(auto c = sandbox->cursor(); !c->at_end(); c->increment()) {
+		types.emplace(c->name(), c->file()->type());
+	}
+
+	CHECK(std::unordered_map<std::string, std::filesystem::file_type>{
+	          {"foo", std::filesystem::file_type::regular},
+	          {"bar", std::filesystem::file_type::directory},
+	          {"baz", std::filesystem::file_type::symlink},
+	      }
+	      == types);
+}
+
+TEST_CASE("OsDirectory replaced at its path") {
+	auto const sandbox = std::make_shared<vfs::impl::TempDirectory>();
+	auto const [d, ok] = sandbox->emplace_directory("foo");
+	REQUIRE(ok);
+	REQUIRE(d->emplace_regular_file("bar").second);
+
+	auto const p = sandbox->path() / "foo";
+	std::filesystem::remove_all(p);
+	std::filesystem::create_directory(p);
+	std::ofstream(p / "baz") << testing::QuoteA;
+
+	CHECK(not d->contains("bar"));
+	CHECK(d->contains("baz"));
+	CHECK(nullptr != d->next("baz"));
+
+	REQUIRE(d->emplace_regular_file("qux").second);
+	CHECK(std::filesystem::is_regular_file(p / "qux"));
+
+	std::vector<std::string> names;
+	for(auto c = d->cursor(); !c->at_end(); c->increment()) {
+		names.push_back(c->name());
+	}
+	std::sort(names.begin(), names.end());
+	CHECK(std::vector<std::string>{"baz", "qux"} == names);
+}
+
+TEST_CASE("OsFile::stat") {
+	auto const sandbox = std::make_shared<vfs::impl::TempDirectory>();
+	auto const [f, ok] = sandbox->emplace_regular_file("foo");
+	REQUIRE(ok);
+
+	auto const& os_f = dynamic_cast<vfs::impl::OsRegularFile const&>(*f);
+	CHECK(0 == f->size());
+
+	SECTION("is cleared by writes through the file") {
+		f->write_all(testing::QuoteA, std::ios_base::out);
+		CHECK(testing::QuoteA.size() == f->size());
+
+		*f->open_write(std::ios_base::app) << testing::QuoteB;
+		CHECK(testing::QuoteA.size() + testing::QuoteB.size() == f->size());
+
+		auto const h = f->open_handle(std::ios_base::in | std::ios_base::out);
+		CHECK(testing::QuoteA.size() + testing::QuoteB.size() == f->size());
+		h->truncate(3);
+		CHECK(3 == f->size());
+	}
+
+	SECTION("is kept until refreshed for changes made by others") {
+		std::ofstream(os_f.path()) << testing::QuoteA;
+		CHECK(0 == f->size());
+
+		os_f.refresh();
+		CHECK(testing::QuoteA.size() == f->size());
+	}
+}
@@ -1,8 +1,20 @@
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <ios>
 #include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
 
 #include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
 
 #include <vfs/fs.hpp>
+#include <vfs/impl/os_file.hpp>
+#include <vfs/impl/os_fs.hpp>
 
 #include "testing/suites/fs.hpp"
 #include "testing.hpp"
@@ -28,3 +40,133 @@ class TestChRootedOsFs: public testing::suites::TestFsFixture {
 };
 
 METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestChRootedOsFs>::test, "OsFs with chroot");
+
+TEST_CASE("ChRootedStdFs::os_path_of") {
+	auto const sandbox = std::make_shared<vfs::impl::TempDirectory>();
+	auto const base    = std::filesystem::canonical(sandbox->path());
+	std::filesystem::create_directories(base / "foo" / "bar");
+	std::filesystem::create_symlink("/", base / "root");
+	std::filesystem::create_symlink("../..", base / "foo" / "up");
+
+	auto const fs = vfs::impl::ChRootedStdFs(base, "/foo", "/tmp");
+
+	CHECK(base == fs.os_path_of("/"));
+	CHECK(base / "foo" / "bar" == fs.os_path_of("bar"));
+	CHECK(base / "foo" / "bar" / "baz" / "qux" == fs.os_path_of("bar/baz/qux"));
+	CHECK(base / "foo" / "bar" == fs.os_path_of("/foo/bar"));
+	CHECK(base / "bar" == fs.os_path_of("../../bar"));
+	CHECK(base / "etc" == fs.os_path_of("/root/etc"));
+	CHECK(base / "bar" == fs.os_path_of("up/bar"));
+}
+
+TEST_CASE("StdFs::status_many on many paths") {
+	auto const fs = testing::cd_temp_dir(*vfs::make_os_fs());
+
+	std::vector<std::filesystem::path> ps;
+	for(std::size_t i = 0; i < 1000; ++i) {
+		auto p = std::filesystem::path(std::to_string(i));
+		if(i % 2 == 0) {
+			fs->write_file(p, p.native());
+		}
+		ps.push_back(std::move(p));
+	}
+
+	SECTION("on the caller") {
+		auto const rst = fs->status_many(ps);
+		REQUIRE(ps.size() == rst.size());
+		for(std::size_t i = 0; i < ps.size(); ++i) {
+			CHECK(!rst.errors[i]);
+			if(i % 2 == 0) {
+				CHECK(std::filesystem::file_type::regular == rst.types[i]);
+				CHECK(ps[i].native().size() == rst.sizes[i]);
+			} else {
+				CHECK(std::filesystem::file_type::not_found == rst.types[i]);
+			}
+		}
+	}
+
+	SECTION("from callbacks on the I/O engine") {
+		// More callbacks than the threads of the engine, so they must not wait for each other.
+		std::vector<std::future<std::size_t>> regulars;
+		for(std::size_t i = 0; i < 64; ++i) {
+			auto done = std::make_shared<std::promise<std::size_t>>();
+			regulars.push_back(done->get_future());
+			fs->async_status(ps[0], [&fs, &ps, done](std::error_code, std::filesystem::file_status) {
+				auto const rst = fs->status_many(ps);
+				done->set_value(std::count(rst.types.begin(), rst.types.end(), std::filesystem::file_type::regular));
+			});
+		}
+		for(auto& r: regulars) {
+			CHECK(ps.size() / 2 == r.get());
+		}
+	}
+
+	fs->remove_all(fs->current_path());
+}
+
+TEST_CASE("StdFs::async_* on many files at once") {
+	auto const fs = testing::cd_temp_dir(*vfs::make_os_fs());
+
+	// More than the I/O engine keeps in flight, each larger than a read probes for EOF.
+	constexpr std::size_t N = 1000;
+
+	std::vector<std::promise<std::error_code>> written(N);
+	std::vector<std::future<std::error_code>>  written_futures;
+	for(auto& w: written) {
+		written_futures.push_back(w.get_future());
+	}
+	for(std::size_t i = 0; i < N; ++i) {
+		fs->async_write_file(std::to_string(i), std::string(1000 + i, 'a' + (i % 26)), std::ios_base::out, [&, i](std::error_code ec) {
+			written[i].set_value(ec);
+		});
+	}
+	for(auto& f: written_futures) {
+		CHECK(!f.get());
+	}
+
+	std::vector<std::promise<std::pair<std::error_code, std::string>>> read(N);
+	std::vector<std::future<std::pair<std::error_code, std::string>>>  read_futures;
+	for(auto& r: read) {
+		read_futures.push_back(r.get_future());
+	}
+	for(std::size_t i = 0; i < N; ++i) {
+		fs->async_read_file(std::to_string(i), [&, i](std::error_code ec, std::string data) {
+			read[i].set_value({ec, std::move(data)});
+		});
+	}
+	for(std::size_t i = 0; i < N; ++i) {
+		auto const [ec, data] = read_futures[i].get();
+		CHECK(!ec);
+		CHECK(std::string(1000 + i, 'a' + (i % 26)) == data);
+	}
+
+	SECTION("fails as the synchronous ones do") {
+		fs->create_directory("foo");
+
+		std::promise<std::error_code> read_dir;
+		fs->async_read_file("foo", [&](std::error_code ec, std::string) {
+			read_dir.set_value(ec);
+		});
+		CHECK(std::errc::is_a_directory == read_dir.get_future().get());
+
+		std::promise<std::error_code> write_dir;
+		fs->async_write_file("foo", "bar", std::ios_base::out, [&](std::error_code ec) {
+			write_dir.set_value(ec);
+		});
+		CHECK(std::errc::is_a_directory == write_dir.get_future().get());
+
+		std::promise<std::pair<std::error_code, std::filesystem::file_status>> missing;
+		fs->async_status("bar", [&](std::error_code ec, std::filesystem::file_status s) {
+			missing.set_value({ec, s});
+		});
+
+		std::error_code ec;
+		auto const expected = fs->status("bar", ec);
+
+		auto const [missing_ec, s] = missing.get_future().get();
+		CHECK(ec == missing_ec);
+		CHECK(expected.type() == s.type());
+	}
+
+	fs->remove_all(fs->current_path());
+}
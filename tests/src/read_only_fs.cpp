@@ -1,5 +1,7 @@
+#include <array>
 #include <filesystem>
 #include <functional>
+#include <string>
 #include <system_error>
 
 #include <catch2/catch_template_test_macros.hpp>
@@ -42,6 +44,8 @@ TEST_CASE("ReadOnlyFsProxy") {
 		CHECK(std::errc::read_only_file_system != test([&] { readonly->last_write_time("foo", ec); }));
 		CHECK(std::errc::read_only_file_system == test([&] { readonly->last_write_time("foo", fs::file_time_type{}, ec); }));
 		CHECK(std::errc::read_only_file_system == test([&] { readonly->permissions("foo", fs::perms::all, ec); }));
+		CHECK(std::errc::read_only_file_system != test([&] { (void)readonly->read_file("foo", ec); }));
+		CHECK(std::errc::read_only_file_system != test([&] { std::array<char, 8> buf{}; (void)readonly->read_at("foo", 0, buf, ec); }));
 		CHECK(std::errc::read_only_file_system != test([&] { readonly->read_symlink("foo", ec); }));
 		CHECK(std::errc::read_only_file_system == test([&] { readonly->remove("foo", ec); }));
 		CHECK(std::errc::read_only_file_system == test([&] { readonly->remove_all("foo", ec); }));
@@ -52,5 +56,12 @@ TEST_CASE("ReadOnlyFsProxy") {
 		CHECK(std::errc::read_only_file_system != test([&] { readonly->symlink_status("foo", ec); }));
 		CHECK(std::errc::read_only_file_system != test([&] { readonly->temp_directory_path(ec); }));
 		CHECK(std::errc::read_only_file_system != test([&] { readonly->is_empty("foo", ec); }));
+		CHECK(std::errc::read_only_file_system == test([&] { readonly->write_file("foo", "bar", std::ios_base::out, ec); }));
+		CHECK(std::errc::read_only_file_system != test([&] { (void)readonly->open_file("foo", std::ios_base::in); }));
+		CHECK(std::errc::read_only_file_system == test([&] { (void)readonly->open_file("foo", std::ios_base::out); }));
+		CHECK(std::errc::read_only_file_system != test([&] { readonly->async_read_file("foo", [&](std::error_code e, std::string) { ec = e; }); }));
+		CHECK(std::errc::read_only_file_system == test([&] { readonly->async_write_file("foo", "bar", std::ios_base::out, [&](std::error_code e) { ec = e; }); }));
+		CHECK(std::errc::read_only_file_system != test([&] { readonly->async_status("foo", [&](std::error_code e, fs::file_status) { ec = e; }); }));
+		CHECK(std::errc::read_only_file_system == test([&] { readonly->async_copy("foo", "bar", fs::copy_options::none, [&](std::error_code e) { ec = e; }); }));
 	}
 }
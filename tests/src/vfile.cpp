@@ -1,9 +1,18 @@
+#include <cstdint>
+#include <filesystem>
+#include <ios>
 #include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
 
 #include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
 
+#include <vfs/impl/lookup_cache.hpp>
 #include <vfs/impl/vfile.hpp>
 
+#include "testing.hpp"
 #include "testing/suites/file.hpp"
 
 class TestVFile: public testing::suites::TestFileFixture {
@@ -14,3 +23,170 @@ class TestVFile: public testing::suites::TestFileFixture {
 };
 
 METHOD_AS_TEST_CASE(testing::suites::TestFile<TestVFile>::test, "VFile");
+
+class TestSortedVFile: public testing::suites::TestFileFixture {
+   public:
+	std::shared_ptr<vfs::impl::Directory> make() {
+		return std::make_shared<vfs::impl::SortedVDirectory>();
+	}
+};
+
+METHOD_AS_TEST_CASE(testing::suites::TestFile<TestSortedVFile>::test, "VFile with sorted directories");
+
+TEST_CASE("SortedVDirectory") {
+	auto const root = std::make_shared<vfs::impl::SortedVDirectory>();
+	root->emplace_regular_file("c");
+	root->emplace_directory("a");
+	root->emplace_symlink("d", "a");
+	root->emplace_regular_file("b");
+
+	SECTION("lists entries in order of names") {
+		std::vector<std::string> names;
+		for(auto const& [name, _]: *root) {
+			names.push_back(name);
+		}
+		CHECK(std::vector<std::string>{"a", "b", "c", "d"} == names);
+	}
+
+	SECTION("makes sorted subdirectories") {
+		auto const [d, ok] = root->emplace_directory("e");
+		REQUIRE(ok);
+		CHECK(nullptr != std::dynamic_pointer_cast<vfs::impl::SortedVDirectory>(d));
+
+		auto const [a, a_ok] = root->emplace_directory("a");
+		CHECK(not a_ok);
+		CHECK(nullptr != std::dynamic_pointer_cast<vfs::impl::SortedVDirectory>(a));
+	}
+
+	SECTION("keeps order on removal") {
+		CHECK(1 == root->erase("b"));
+		CHECK(not root->contains("b"));
+		CHECK(root->unlink("a"));
+		CHECK(nullptr == root->next("a"));
+
+		std::vector<std::string> names;
+		for(auto const& [name, _]: *root) {
+			names.push_back(name);
+		}
+		CHECK(std::vector<std::string>{"c", "d"} == names);
+	}
+}
+
+TEST_CASE("VRegularFile") {
+	constexpr std::uintmax_t SpillSize = 64;
+
+	auto const f = std::make_shared<vfs::impl::VRegularFile>(vfs::impl::RegularFile::DefaultPerms, SpillSize);
+	REQUIRE(f->in_memory());
+
+	std::string const small(SpillSize / 2, 'a');
+	std::string const large(SpillSize * 2, 'b');
+
+	SECTION("stays in memory while small") {
+		f->write_all(small, std::ios_base::out);
+		CHECK(f->in_memory());
+		CHECK(small == f->read_all());
+	}
+
+	SECTION("spills when written large") {
+		f->write_all(small, std::ios_base::out);
+		f->write_all(large, std::ios_base::app);
+		CHECK(not f->in_memory());
+		CHECK(small + large == f->read_all());
+	}
+
+	SECTION("spills on the next write after a stream writing it is closed") {
+		{
+			auto const os = f->open_write(std::ios_base::out);
+			*os << large;
+			os->flush();
+			CHECK(f->in_memory());
+		}
+
+		CHECK(f->in_memory());
+		CHECK(large == testing::read_all(*f->open_read(std::ios_base::in)));
+
+		f->write_all(small, std::ios_base::app);
+		CHECK(not f->in_memory());
+		CHECK(large + small == f->read_all());
+	}
+
+	SECTION("does not spill while a handle is open") {
+		auto h = f->open_handle(std::ios_base::out);
+		h->pwrite(large, 0);
+		f->write_all(small, std::ios_base::app);
+		CHECK(f->in_memory());
+
+		h.reset();
+		CHECK(f->in_memory());
+
+		f->write_all(small, std::ios_base::app);
+		CHECK(not f->in_memory());
+		CHECK(large + small + small == f->read_all());
+	}
+
+	SECTION("spills on resize") {
+		f->resize(SpillSize);
+		CHECK(not f->in_memory());
+		CHECK(SpillSize == f->size());
+	}
+
+	SECTION("keeps permissions of its own") {
+		auto const src = std::make_shared<vfs::impl::VRegularFile>(vfs::impl::RegularFile::DefaultPerms, SpillSize);
+		src->write_all(large, std::ios_base::out);
+		src->perms(std::filesystem::perms::owner_read, std::filesystem::perm_options::replace);
+
+		f->copy_from(*src);
+		CHECK(std::filesystem::perms::owner_read == f->perms());
+		CHECK(not f->in_memory());
+
+		f->write_all(small, std::ios_base::app);
+		CHECK(large + small == f->read_all());
+	}
+}
+
+TEST_CASE("LookupCache") {
+	auto const a = std::make_shared<vfs::impl::VDirectory>();
+	auto const b = std::make_shared<vfs::impl::VDirectory>();
+
+	auto const [foo, _] = a->emplace_regular_file("foo");
+
+	vfs::impl::LookupCache cache;
+	auto const             watch_a = [&] {
+		vfs::impl::ChangeWatch watch;
+		a->watch_changes(watch);
+		return watch;
+	};
+
+	cache.insert("foo", false, foo, watch_a());
+	cache.insert("bar", false, std::make_error_code(std::errc::no_such_file_or_directory), nullptr, watch_a());
+	REQUIRE(cache.find("foo", false).has_value());
+	REQUIRE(cache.find("bar", false).has_value());
+	CHECK(not cache.find("foo", true).has_value());
+
+	SECTION("records are kept on changes in unwatched directories") {
+		b->emplace_regular_file("foo");
+		b->erase("foo");
+		CHECK(cache.find("foo", false).has_value());
+		CHECK(cache.find("bar", false).has_value());
+	}
+
+	SECTION("failed lookups are dropped on insertion") {
+		a->emplace_directory("baz");
+		CHECK(cache.find("foo", false).has_value());
+		CHECK(not cache.find("bar", false).has_value());
+	}
+
+	SECTION("records are dropped on removal") {
+		a->emplace_directory("baz");
+		a->erase("baz");
+		CHECK(not cache.find("foo", false).has_value());
+		CHECK(not cache.find("bar", false).has_value());
+	}
+
+	SECTION("stale records are not inserted") {
+		auto watch = watch_a();
+		a->unlink("foo");
+		cache.insert("baz", false, foo, std::move(watch));
+		CHECK(not cache.find("baz", false).has_value());
+	}
+}
@@ -1,10 +1,19 @@
+#include <filesystem>
+#include <future>
+#include <ios>
 #include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
 
 #include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
 
 #include <vfs/fs.hpp>
 
 #include "testing/suites/fs.hpp"
+#include "testing.hpp"
 
 class TestVfs: public testing::suites::TestFsFixture {
    public:
@@ -27,3 +36,180 @@ class TestChRootedVfs: public testing::suites::TestFsFixture {
 };
 
 METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestChRootedVfs>::test, "Vfs with chroot");
+
+class TestCachedVfs: public testing::suites::TestFsFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make() override {
+		return vfs::make_vfs("/tmp", {.cache_lookups = true});
+	}
+};
+
+METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestCachedVfs>::test, "Vfs with lookup cache");
+
+class TestSortedVfs: public testing::suites::TestFsFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make() override {
+		return vfs::make_vfs("/tmp", {.sorted_directories = true});
+	}
+};
+
+METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestSortedVfs>::test, "Vfs with sorted directories");
+
+class TestConcurrentVfs: public testing::suites::TestFsFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make() override {
+		return vfs::make_vfs("/tmp", {.cache_lookups = true, .concurrent = true});
+	}
+};
+
+METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestConcurrentVfs>::test, "Vfs with concurrent");
+
+class TestOsMountedVfs: public testing::suites::TestFsFixture {
+   public:
+	std::shared_ptr<vfs::Fs> make() override {
+		auto const os = testing::cd_temp_dir(*vfs::make_os_fs());
+		auto       fs = vfs::make_vfs();
+		fs->create_directories("/tmp");
+		fs->mount("/tmp", *os, ".");
+
+		return fs;
+	}
+};
+
+METHOD_AS_TEST_CASE(testing::suites::TestFsBasic<TestOsMountedVfs>::test, "Vfs with OsFs mounted");
+
+TEST_CASE("Vfs lookup cache") {
+	auto fs = vfs::make_vfs("/tmp", {.cache_lookups = true});
+	fs->create_directories("/a/b");
+	fs->create_symlink("/a/b", "/l");
+
+	CHECK(fs->is_directory("/l/"));
+	CHECK(fs->is_symlink("/l"));
+	CHECK(not fs->exists("/a/b/c"));
+	CHECK(not fs->exists("/l/c"));
+
+	SECTION("failed lookups are invalidated by creation") {
+		fs->create_directory("/a/b/c");
+		CHECK(fs->is_directory("/a/b/c"));
+		CHECK(fs->is_directory("/l/c"));
+
+		*fs->open_write("/a/b/c/d") << "foo";
+		CHECK(fs->is_regular_file("/l/c/d"));
+		CHECK(3 == fs->file_size("/l/c/d"));
+	}
+
+	SECTION("lookups are invalidated by removal") {
+		fs->remove_all("/a/b");
+		CHECK(not fs->exists("/l"));
+		CHECK(fs->is_symlink("/l"));
+
+		*fs->open_write("/a/b") << "foo";
+		CHECK(fs->is_regular_file("/l"));
+	}
+
+	SECTION("lookups are invalidated by rename") {
+		fs->rename("/a/b", "/a/c");
+		CHECK(not fs->exists("/l"));
+		CHECK(fs->is_directory("/a/c"));
+
+		fs->rename("/a/c", "/a/b");
+		CHECK(fs->is_directory("/l"));
+	}
+
+	SECTION("lookups are invalidated by mount") {
+		auto other = vfs::make_mem_fs();
+		*other->open_write("foo") << "bar";
+
+		fs->mount("/a/b", *other, "/");
+		CHECK(fs->is_regular_file("/l/foo"));
+
+		fs->unmount("/a/b");
+		CHECK(not fs->exists("/l/foo"));
+	}
+
+	SECTION("relative lookups are resolved from each working directory") {
+		*fs->open_write("/a/b/foo") << "bar";
+
+		auto const a = fs->current_path("/a");
+		auto const b = fs->current_path("/a/b");
+		CHECK(a->is_directory("b"));
+		CHECK(b->is_regular_file("foo"));
+		CHECK(not a->exists("foo"));
+	}
+}
+
+TEST_CASE("Vfs::async_* on an OsFs mounted") {
+	auto const os  = testing::cd_temp_dir(*vfs::make_os_fs());
+	auto const sut = vfs::make_vfs();
+	sut->create_directory("/os");
+	sut->mount("/os", *os, ".");
+
+	// Files on the OS complete on the I/O engine, so not on this thread.
+	auto const caller = std::this_thread::get_id();
+
+	using Done = std::promise<std::pair<std::thread::id, std::error_code>>;
+
+	Done written;
+	sut->async_write_file("/os/foo", std::string(testing::QuoteA), std::ios_base::out, [&](std::error_code ec) {
+		written.set_value({std::this_thread::get_id(), ec});
+	});
+	{
+		auto const [id, ec] = written.get_future().get();
+		CHECK(caller != id);
+		CHECK(!ec);
+		CHECK(testing::QuoteA == os->read_file("foo"));
+	}
+
+	std::string data;
+
+	Done read;
+	sut->async_read_file("/os/foo", [&](std::error_code ec, std::string d) {
+		data = std::move(d);
+		read.set_value({std::this_thread::get_id(), ec});
+	});
+	{
+		auto const [id, ec] = read.get_future().get();
+		CHECK(caller != id);
+		CHECK(!ec);
+		CHECK(testing::QuoteA == data);
+	}
+
+	std::filesystem::file_status s;
+
+	Done stat;
+	sut->async_status("/os/foo", [&](std::error_code ec, std::filesystem::file_status st) {
+		s = st;
+		stat.set_value({std::this_thread::get_id(), ec});
+	});
+	{
+		auto const [id, ec] = stat.get_future().get();
+		CHECK(caller != id);
+		CHECK(!ec);
+		CHECK(std::filesystem::file_type::regular == s.type());
+	}
+
+	Done copied;
+	// Not into the mount point itself, which is not a directory of the OS.
+	os->create_directory("qux");
+	sut->async_copy("/os/foo", "/os/qux/bar", std::filesystem::copy_options::none, [&](std::error_code ec) {
+		copied.set_value({std::this_thread::get_id(), ec});
+	});
+	{
+		auto const [id, ec] = copied.get_future().get();
+		CHECK(caller != id);
+		CHECK(!ec);
+		CHECK(testing::QuoteA == sut->read_file("/os/qux/bar"));
+	}
+
+	Done in_memory;
+	sut->async_write_file("/baz", "qux", std::ios_base::out, [&](std::error_code ec) {
+		in_memory.set_value({std::this_thread::get_id(), ec});
+	});
+	{
+		auto const [id, ec] = in_memory.get_future().get();
+		CHECK(caller == id);
+		CHECK(!ec);
+	}
+
+	os->remove_all(os->current_path());
+}